@@ -20,9 +20,21 @@ static inline void *realloc_it(void *ptrmem, size_t size) {
 	return p;
 }
 
+/* Token allocator growing the token array with realloc() */
+static jsmn_Token *grow_tokens(void *ctx, jsmn_Token *toks, size_t len) {
+	return realloc(toks, sizeof(*toks) * len);
+}
+
+static void free_tokens(void *ctx, jsmn_Token *toks) {
+	free(toks);
+}
+
+static const jsmn_Allocator allocator = { grow_tokens, free_tokens, NULL };
+
 /*
- * An example of reading JSON from stdin and printing its content to stdout.
- * The output looks like YAML, but I'm not sure if it's really compatible.
+ * An example of reading JSON from a file or stdin and printing its content to
+ * stdout. The output looks like YAML, but I'm not sure if it's really
+ * compatible.
  */
 
 static int dump(const char *js, jsmn_Token *t, size_t count, int indent) {
@@ -31,10 +43,10 @@ static int dump(const char *js, jsmn_Token *t, size_t count, int indent) {
 		return 0;
 	}
 	if (t->type == JSMN_PRIMITIVE) {
-		printf("%.*s", t->length, t->data);
+		printf("%.*s", t->length, js + t->start);
 		return 1;
 	} else if (t->type == JSMN_LABEL || t->type == JSMN_STRING) {
-		printf("'%.*s'",t->length, t->data);
+		printf("'%.*s'",t->length, js + t->start);
 		return 1;
 	} else if (t->type == JSMN_OBJECT) {
 		printf("\n");
@@ -61,7 +73,28 @@ static int dump(const char *js, jsmn_Token *t, size_t count, int indent) {
 	return 0;
 }
 
-int main() {
+#ifdef JSMN_MMAP
+/* Maps a regular file and parses it in one go, without copying */
+static int dump_file(const char *path) {
+	int r;
+	jsmn_File f;
+
+	if (path != NULL) {
+		r = jsmn_parse_file(&f, path, &allocator);
+	} else {
+		r = jsmn_parse_fd(&f, STDIN_FILENO, &allocator);
+	}
+	if (r >= 0) {
+		dump(f.js, f.parser.factory.toks, f.parser.factory.toknext, 0);
+	} else if (r != JSMN_ERROR_IO) {
+		fprintf(stderr, "jsmn_parse(): %d\n", r);
+	}
+	jsmn_file_close(&f);
+	return r;
+}
+#endif
+
+int main(int argc, char **argv) {
 	int r;
 	int eof_expected = 0;
 	char *js = NULL;
@@ -69,18 +102,27 @@ int main() {
 	char buf[BUFSIZ];
 
 	jsmn_Parser p;
-	jsmn_Token *tok;
-	size_t tokcount = 2;
-
-	/* Allocate some tokens as a start */
-	tok = malloc(sizeof(*tok) * tokcount);
-	if (tok == NULL) {
-		fprintf(stderr, "malloc(): errno=%d\n", errno);
-		return 3;
+
+#ifdef JSMN_MMAP
+	r = dump_file(argc > 1 ? argv[1] : NULL);
+	if (r >= 0) {
+		return EXIT_SUCCESS;
+	} else if (r != JSMN_ERROR_IO) {
+		return 2;
+	} else if (argc > 1) {
+		fprintf(stderr, "%s: cannot map file, errno=%d\n", argv[1], errno);
+		return 1;
 	}
+	/* Pipes and terminals cannot be mapped, read them chunk by chunk */
+#else
+	if (argc > 1 && freopen(argv[1], "r", stdin) == NULL) {
+		fprintf(stderr, "%s: cannot open file, errno=%d\n", argv[1], errno);
+		return 1;
+	}
+#endif
 
-	/* Prepare parser */
-	jsmn_parser_init(&p, tok, tokcount);
+	/* Prepare parser, it allocates the tokens as needed */
+	jsmn_parser_init_alloc(&p, &allocator);
 
 	for (;;) {
 		/* Read another chunk */
@@ -90,6 +132,7 @@ int main() {
 			return 1;
 		}
 		if (r == 0) {
+			jsmn_factory_free(&p.factory);
 			if (eof_expected != 0) {
 				return 0;
 			} else {
@@ -105,22 +148,13 @@ int main() {
 		strncpy(js + jslen, buf, r);
 		jslen = jslen + r;
 
-again:
-		r = jsmn_parse(&p, js, jslen);
-		if (r < 0) {
-			if (r == JSMN_ERROR_NOMEM) {
-				tokcount = tokcount * 2;
-				tok = realloc_it(tok, sizeof(*tok) * tokcount);
-				if (tok == NULL) {
-					return 3;
-				}
-				/* Update parser */
-				p.factory.toks = tok;
-				p.factory.tokslen = tokcount;
-				goto again;
-			}
-		} else {
-			dump(js, tok, p.factory.toknext, 0);
+		/* Only the new bytes are parsed, tokens refer to js by offset */
+		r = jsmn_stream_parse(&p, js, jslen);
+		if (r == JSMN_ERROR_NOMEM) {
+			fprintf(stderr, "jsmn_stream_parse(): out of memory\n");
+			return 3;
+		} else if (r >= 0) {
+			dump(js, p.factory.toks, p.factory.toknext, 0);
 			eof_expected = 1;
 		}
 	}
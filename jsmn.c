@@ -1,316 +1,2710 @@
 #include <string.h>
+#include <limits.h>
+#include <float.h>
 
 #include "jsmn.h"
 
+#ifdef JSMN_HOSTED
+#include <stdio.h>
+#endif
+
+#ifdef JSMN_POSIX
+#include <sys/uio.h>
+#include <errno.h>
+#endif
+
+#ifdef JSMN_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef JSMN_THREADS
+#include <stdlib.h>
+#include <pthread.h>
+#endif
+
+// The structural indexer uses SSE2/AVX2 on x86 with GCC compatible compilers,
+// define JSMN_NO_SIMD to always use the plain byte loops.
+#if !defined(JSMN_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+        (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define JSMN_SIMD 1
+#include <immintrin.h>
+#endif
+
 /**
- * Allocates a fresh unused token from the token pull.
+ * Character classes looked up by the structural indexer.
  */
-static jsmn_Token *jsmn_alloc_token(jsmn_Factory *factory, size_t len) {
-    int i;
-    jsmn_Token *tok;
-    if (factory->toknext + (len - 1) >= factory->tokslen) {
-        return NULL;
-    }
-    for (i = 0; i < len; i++) {
-        tok = factory->toks + factory->toknext++;
-        tok->type = JSMN_UNDEFINED;
-        tok->data = NULL;
-        tok->length = -1;
-        tok->size = 0;
-        tok->parent = -1;
+enum {
+    // Bytes the main loop has to look at, i.e. anything but whitespace
+    JSMN_INDEX_VALUE = 0,
+    // Quotes, backslashes and NUL bytes within a string
+    JSMN_INDEX_STRING = 1,
+    // Delimiters and invalid bytes of a primitive
+    JSMN_INDEX_PRIMITIVE = 2,
+    JSMN_INDEX_CLASSES = 3
+};
+
+/**
+ * State of skipping an object or array.
+ */
+typedef struct {
+    int depth; // number of open objects and arrays
+    int string; // within a string
+    int escaped; // the next byte is escaped
+} jsmn_Skip;
+
+/**
+ * Skips the bytes from 'pos' up to 'end' one by one. Returns the position
+ * after the skipped value, 0 if it does not end before 'end' or
+ * JSMN_ERROR_PART at a NUL byte.
+ */
+static int jsmn_skip_bytes(jsmn_Skip *skip, const char *js, size_t pos,
+        size_t end)
+{
+    for (; pos < end; pos++) {
+        char c = js[pos];
+        if (skip->escaped) {
+            skip->escaped = 0;
+        } else if (c == '\0') {
+            return JSMN_ERROR_PART;
+        } else if (skip->string) {
+            if (c == '\\') {
+                skip->escaped = 1;
+            } else if (c == '\"') {
+                skip->string = 0;
+            }
+        } else if (c == '\"') {
+            skip->string = 1;
+        } else if (c == '{' || c == '[') {
+            skip->depth++;
+        } else if ((c == '}' || c == ']') && --skip->depth == 0) {
+            return pos + 1;
+        }
     }
-    return tok - (len - 1);
+    return 0;
 }
 
 /**
- * Fills token type and boundaries.
+ * Classifies the primitive of 'len' bytes at 's' by the JSON grammar.
  */
-static void jsmn_fill_token(jsmn_Token *token, jsmntype_t type, const char *js,
-                            int start, int end) {
-    token->type = type;
-    token->data = js + start;
-    token->length = end - start;
-    token->size = 0;
+static jsmnkind_t jsmn_classify_primitive(const char *s, int len)
+{
+    jsmnkind_t kind = JSMN_KIND_INTEGER;
+    int i = 0;
+
+    switch (s[0]) {
+        case 't':
+            return len == 4 && memcmp(s, "true", 4) == 0 ?
+                    JSMN_KIND_TRUE : JSMN_KIND_INVALID;
+        case 'f':
+            return len == 5 && memcmp(s, "false", 5) == 0 ?
+                    JSMN_KIND_FALSE : JSMN_KIND_INVALID;
+        case 'n':
+            return len == 4 && memcmp(s, "null", 4) == 0 ?
+                    JSMN_KIND_NULL : JSMN_KIND_INVALID;
+        case '-':
+            i++;
+            break;
+    }
+    if (i < len && s[i] == '0') {
+        i++;
+    } else {
+        if (i >= len || s[i] < '1' || s[i] > '9') return JSMN_KIND_INVALID;
+        while (i < len && s[i] >= '0' && s[i] <= '9') i++;
+    }
+    if (i < len && s[i] == '.') {
+        kind = JSMN_KIND_FLOAT;
+        if (++i >= len || s[i] < '0' || s[i] > '9') return JSMN_KIND_INVALID;
+        while (i < len && s[i] >= '0' && s[i] <= '9') i++;
+    }
+    if (i < len && (s[i] == 'e' || s[i] == 'E')) {
+        kind = JSMN_KIND_FLOAT;
+        if (++i < len && (s[i] == '+' || s[i] == '-')) i++;
+        if (i >= len || s[i] < '0' || s[i] > '9') return JSMN_KIND_INVALID;
+        while (i < len && s[i] >= '0' && s[i] <= '9') i++;
+    }
+    return i == len ? kind : JSMN_KIND_INVALID;
 }
 
-void jsmn_factory_init(jsmn_Factory *factory, jsmn_Token *toks, size_t len) {
-    factory->toks = toks;
-    factory->tokslen = len;
-    factory->toknext = 0;
-    factory->toksuper = -1;
+/**
+ * State of counting tokens.
+ */
+typedef struct {
+    int count; // number of tokens started so far
+    int string; // within a string
+    int escaped; // the next byte is escaped
+    int primitive; // the previous byte belongs to a primitive
+} jsmn_Count;
+
+#ifdef JSMN_STRICT
+/**
+ * Checks the grammar of the primitive starting at 'pos', which ends at the
+ * next byte not belonging to a primitive or at 'len'.
+ */
+static int jsmn_count_primitive(const char *js, size_t pos, size_t len)
+{
+    size_t end = pos;
+    for (; end < len; end++) {
+        char c = js[end];
+        if (c == '\t' || c == '\r' || c == '\n' || c == ' ' || c == ',' ||
+                c == ']' || c == '}' || c == ':' || c == '{' || c == '[' ||
+                c == '\"' || c == '\0') {
+            break;
+        }
+    }
+    return jsmn_classify_primitive(js + pos, end - pos) != JSMN_KIND_INVALID;
 }
+#endif
 
-static jsmn_Token *jsmn_prepare_append(jsmn_Factory *factory, const char *name)
+/**
+ * Counts the tokens starting at the bytes from 'pos' up to 'end' one by one,
+ * primitives may go on up to 'len'. Returns 0, or -1 at a byte which only the
+ * parser itself can handle, like a NUL byte or a quote or bracket within a
+ * primitive, or in strict mode at an invalid primitive.
+ */
+static int jsmn_count_bytes(jsmn_Count *cnt, const char *js, size_t pos,
+        size_t end, size_t len)
 {
-    jsmn_Token *token;
-    int n_tokens = 1;
-    // Does the append going to be within a supertoken 
-    if (factory->toksuper != -1) {
-        // If the append is with in a object a label token is needed.
-        if (factory->toks[factory->toksuper].type == JSMN_OBJECT) {
-            if (name == NULL) {
-                // Exit with an error, if no name for a label token is defined
-                return NULL;
+    for (; pos < end; pos++) {
+        char c = js[pos];
+        if (c == '\0') {
+            return -1;
+        } else if (cnt->string) {
+            if (cnt->escaped) {
+                cnt->escaped = 0;
+            } else if (c == '\\') {
+                cnt->escaped = 1;
+            } else if (c == '\"') {
+                cnt->string = 0;
             }
-            // Two tokens have to be appended a label and the actual token
-            n_tokens = 2;
+            continue;
+        }
+        switch (c) {
+            case '\t' : case '\r' : case '\n' : case ' ' :
+            case ','  : case ']'  : case '}'  : case ':' :
+                cnt->primitive = 0;
+                break;
+            case '{': case '[': case '\"':
+                if (cnt->primitive) {
+                    return -1;
+                }
+                cnt->string = c == '\"';
+                cnt->count++;
+                break;
+            default:
+                if (cnt->primitive) {
+                    break;
+                }
+#ifdef JSMN_STRICT
+                // Let the parser reject it
+                if (!jsmn_count_primitive(js, pos, len)) {
+                    return -1;
+                }
+#endif
+                cnt->primitive = 1;
+                cnt->count++;
+                break;
         }
     }
-    // Allocate the needed tokens
-    token = jsmn_alloc_token(factory, n_tokens);
-    if (token == NULL) {
-        return NULL;
+    return 0;
+}
+
+#ifdef JSMN_STRICT
+/**
+ * Returns the length of the UTF-8 sequence of two to four bytes at 's', which
+ * has at most 'len' bytes, or 0 if it is invalid, overlong, a surrogate or
+ * beyond U+10FFFF.
+ */
+static int jsmn_utf8_sequence(const unsigned char *s, size_t len)
+{
+    unsigned char c = s[0];
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xbf;
+
+    if (c >= 0xc2 && c <= 0xdf) {
+        return len >= 2 && (s[1] & 0xc0) == 0x80 ? 2 : 0;
     }
-    // Increment the size of the supertoken
-    if (factory->toksuper != -1) {
-        factory->toks[factory->toksuper].size++;
+    if (c >= 0xe0 && c <= 0xef) {
+        if (c == 0xe0) lo = 0xa0;
+        if (c == 0xed) hi = 0x9f;
+        return len >= 3 && s[1] >= lo && s[1] <= hi &&
+                (s[2] & 0xc0) == 0x80 ? 3 : 0;
     }
-    // Append label token
-    if (n_tokens == 2) {
-        int toklabel = token - factory->toks;
-        token->type = JSMN_LABEL;
-        token->data = name;
-        token->length = strlen(name);
-        token->size = 1;
-        // The parent token of the label will be the current supertoken
-        token->parent = factory->toksuper;
-        // Jump the the actual token
-        token++;
-        // The parent of the actual token will be the label token
-        token->parent = toklabel;
-    } else if (factory->toksuper != -1) {
-        // Within an array, set the current supertoken as parent
-        token->parent = factory->toksuper;
-    } else {
-        // As root token, set the parent to -1
-        token->parent = -1;
+    if (c >= 0xf0 && c <= 0xf4) {
+        if (c == 0xf0) lo = 0x90;
+        if (c == 0xf4) hi = 0x8f;
+        return len >= 4 && s[1] >= lo && s[1] <= hi &&
+                (s[2] & 0xc0) == 0x80 && (s[3] & 0xc0) == 0x80 ? 4 : 0;
     }
-    return token;
+    return 0;
 }
+#endif
 
-static int jsmn_start_sequence(jsmn_Factory *factory, jsmntype_t type,
-        const char *name)
+#ifdef JSMN_SIMD
+
+#define JSMN_INDEX_BLOCK 64
+
+/**
+ * Structural index of the block of 64 bytes starting at 'base'.
+ *
+ * Every class has a bit mask with one bit per byte of the block. Bits for
+ * bytes beyond the end of the JSON string are set in all masks, so a lookup
+ * stops at the end of the string.
+ */
+typedef struct {
+    const char *js;
+    size_t len;
+    size_t base;
+    uint64_t masks[JSMN_INDEX_CLASSES];
+} jsmn_Index;
+
+static void jsmn_classify_sse2(const char *block, uint64_t *masks)
 {
-    jsmn_Token *token;
-    // Prepare the token
-    token = jsmn_prepare_append(factory, name);
-    if (token == NULL) {
-        return JSMN_ERROR_FACTORY;
+    int i;
+    masks[JSMN_INDEX_VALUE] = 0;
+    masks[JSMN_INDEX_STRING] = 0;
+    masks[JSMN_INDEX_PRIMITIVE] = 0;
+    for (i = 0; i < JSMN_INDEX_BLOCK; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(block + i));
+        __m128i ws = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                        _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                        _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+        __m128i str = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')),
+                        _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+                _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+        // Signed compare: bytes >= 128 are negative and end up below 32
+        __m128i prim = _mm_or_si128(
+                _mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8(32)),
+                        _mm_cmpeq_epi8(v, _mm_set1_epi8(127))),
+                _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8(','))),
+                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')),
+                                _mm_or_si128(
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8(']')),
+                                        _mm_cmpeq_epi8(v,
+                                                _mm_set1_epi8('}'))))));
+        masks[JSMN_INDEX_VALUE] |=
+                (uint64_t)(uint16_t)~_mm_movemask_epi8(ws) << i;
+        masks[JSMN_INDEX_STRING] |=
+                (uint64_t)(uint16_t)_mm_movemask_epi8(str) << i;
+        masks[JSMN_INDEX_PRIMITIVE] |=
+                (uint64_t)(uint16_t)_mm_movemask_epi8(prim) << i;
     }
-    // Append object token
-    token->type = type;
-    factory->toksuper = token - factory->toks;
-    return factory->toknext;
 }
 
-static int jsmn_end_sequence(jsmn_Factory *factory, jsmntype_t type)
+__attribute__((target("avx2")))
+static void jsmn_classify_avx2(const char *block, uint64_t *masks)
 {
-    jsmn_Token *supertoken;
-    // Check wheter there is a sequence (object or array) to end
-    if (factory->toksuper == -1) {
-        return JSMN_ERROR_FACTORY;
+    int i;
+    masks[JSMN_INDEX_VALUE] = 0;
+    masks[JSMN_INDEX_STRING] = 0;
+    masks[JSMN_INDEX_PRIMITIVE] = 0;
+    for (i = 0; i < JSMN_INDEX_BLOCK; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(block + i));
+        __m256i ws = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+        __m256i str = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"')),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+                _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+        __m256i prim = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(32), v),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(127))),
+                _mm256_or_si256(
+                        _mm256_or_si256(
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))),
+                        _mm256_or_si256(
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')),
+                                _mm256_or_si256(
+                                        _mm256_cmpeq_epi8(v,
+                                                _mm256_set1_epi8(']')),
+                                        _mm256_cmpeq_epi8(v,
+                                                _mm256_set1_epi8('}'))))));
+        masks[JSMN_INDEX_VALUE] |=
+                (uint64_t)(uint32_t)~_mm256_movemask_epi8(ws) << i;
+        masks[JSMN_INDEX_STRING] |=
+                (uint64_t)(uint32_t)_mm256_movemask_epi8(str) << i;
+        masks[JSMN_INDEX_PRIMITIVE] |=
+                (uint64_t)(uint32_t)_mm256_movemask_epi8(prim) << i;
     }
-    supertoken = factory->toks + factory->toksuper;
-    // Check the type of the to be ended sequence
-    if (supertoken->type != type) {
-        return JSMN_ERROR_FACTORY;
+}
+
+/**
+ * Returns the position of the next quote, backslash or NUL byte at or after
+ * 'pos', or 'len' if there is none.
+ */
+static size_t jsmn_scan_string_sse2(const char *js, size_t pos, size_t len)
+{
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i zero = _mm_setzero_si128();
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(js + pos));
+        int mask = _mm_movemask_epi8(_mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                        _mm_cmpeq_epi8(v, backslash)),
+                _mm_cmpeq_epi8(v, zero)));
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
     }
-    if (supertoken->parent != -1) {
-        // Found an other supertoken
-        supertoken = factory->toks + supertoken->parent;
-        // At this state the current supertoken must be a label or an array ...
-        if (supertoken->type == JSMN_LABEL || supertoken->type == JSMN_ARRAY) {
-            // ... set the supertoken of the factory to the parent of the
-            // current supertoken ... 
-            factory->toksuper = supertoken->parent;
-        } else {
-            // ... otherwise there must be an error.
-            return JSMN_ERROR_FACTORY;
+    for (; pos < len; pos++) {
+        if (js[pos] == '\"' || js[pos] == '\\' || js[pos] == '\0') {
+            break;
         }
-    } else {
-        // There is no supertoken -> end of root sequence
-        factory->toksuper = -1;
     }
-    return factory->toknext;
+    return pos;
 }
 
-int jsmn_start_object(jsmn_Factory *factory, const char *name)
+__attribute__((target("avx2")))
+static size_t jsmn_scan_string_avx2(const char *js, size_t pos, size_t len)
 {
-    return jsmn_start_sequence(factory, JSMN_OBJECT, name);
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i zero = _mm256_setzero_si256();
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(js + pos));
+        int mask = _mm256_movemask_epi8(_mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                        _mm256_cmpeq_epi8(v, backslash)),
+                _mm256_cmpeq_epi8(v, zero)));
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return jsmn_scan_string_sse2(js, pos, len);
 }
 
-int jsmn_end_object(jsmn_Factory *factory)
+/**
+ * Finds the next byte of plain text which has to be escaped in JSON.
+ */
+static size_t jsmn_scan_escape_sse2(const char *js, size_t pos, size_t len)
 {
-    return jsmn_end_sequence(factory, JSMN_OBJECT);
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1f);
+    const __m128i zero = _mm_setzero_si128();
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(js + pos));
+        // Unsigned saturation leaves zero for the control characters only
+        int mask = _mm_movemask_epi8(_mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                        _mm_cmpeq_epi8(v, backslash)),
+                _mm_cmpeq_epi8(_mm_subs_epu8(v, control), zero)));
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    for (; pos < len; pos++) {
+        if (js[pos] == '\"' || js[pos] == '\\' ||
+                (unsigned char)js[pos] < 0x20) {
+            break;
+        }
+    }
+    return pos;
 }
 
-int jsmn_start_array(jsmn_Factory *factory, const char *name)
+__attribute__((target("avx2")))
+static size_t jsmn_scan_escape_avx2(const char *js, size_t pos, size_t len)
 {
-    return jsmn_start_sequence(factory, JSMN_ARRAY, name);
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1f);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(js + pos));
+        int mask = _mm256_movemask_epi8(_mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                        _mm256_cmpeq_epi8(v, backslash)),
+                _mm256_cmpeq_epi8(_mm256_subs_epu8(v, control), zero)));
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    // Strings are short, the tail is done here as switching to the legacy
+    // SSE2 encoding with the upper halves in use is a costly transition
+    for (; pos < len; pos++) {
+        if (js[pos] == '\"' || js[pos] == '\\' ||
+                (unsigned char)js[pos] < 0x20) {
+            break;
+        }
+    }
+    return pos;
 }
 
-int jsmn_end_array(jsmn_Factory *factory)
+/**
+ * Bit masks of a block of 64 bytes used to skip a value.
+ */
+enum {
+    JSMN_SKIP_QUOTE = 0,
+    // Backslashes and NUL bytes, the block is looked at byte by byte
+    JSMN_SKIP_SLOW = 1,
+    JSMN_SKIP_OPEN = 2,
+    JSMN_SKIP_CLOSE = 3,
+    JSMN_SKIP_CLASSES = 4
+};
+
+static void jsmn_classify_skip_sse2(const char *block, uint64_t *masks)
 {
-    return jsmn_end_sequence(factory, JSMN_ARRAY);
+    int i;
+    masks[JSMN_SKIP_QUOTE] = 0;
+    masks[JSMN_SKIP_SLOW] = 0;
+    masks[JSMN_SKIP_OPEN] = 0;
+    masks[JSMN_SKIP_CLOSE] = 0;
+    for (i = 0; i < JSMN_INDEX_BLOCK; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(block + i));
+        // '[' and ']' are 0x5b and 0x5d, '{' and '}' are 0x7b and 0x7d
+        __m128i b = _mm_andnot_si128(_mm_set1_epi8(0x20), v);
+        __m128i slow = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')),
+                _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+        masks[JSMN_SKIP_QUOTE] |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(v, _mm_set1_epi8('\"'))) << i;
+        masks[JSMN_SKIP_SLOW] |=
+                (uint64_t)(uint16_t)_mm_movemask_epi8(slow) << i;
+        masks[JSMN_SKIP_OPEN] |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(b, _mm_set1_epi8('['))) << i;
+        masks[JSMN_SKIP_CLOSE] |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(b, _mm_set1_epi8(']'))) << i;
+    }
 }
 
-static int jsmn_append_simple(jsmn_Factory *factory, jsmntype_t type,
-        const char *name, const char *value)
+__attribute__((target("avx2")))
+static void jsmn_classify_skip_avx2(const char *block, uint64_t *masks)
 {
-    jsmn_Token *token;
-    // Prepare the token
-    token = jsmn_prepare_append(factory, name);
-    if (token == NULL) {
-        return JSMN_ERROR_FACTORY;
-    }
-    // Append the data to the string or primitive token
-    token->type = type;
-    token->data = value;
-    if (value != NULL) {
-        token->length = strlen(value);
+    int i;
+    masks[JSMN_SKIP_QUOTE] = 0;
+    masks[JSMN_SKIP_SLOW] = 0;
+    masks[JSMN_SKIP_OPEN] = 0;
+    masks[JSMN_SKIP_CLOSE] = 0;
+    for (i = 0; i < JSMN_INDEX_BLOCK; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(block + i));
+        __m256i b = _mm256_andnot_si256(_mm256_set1_epi8(0x20), v);
+        __m256i slow = _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')),
+                _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+        masks[JSMN_SKIP_QUOTE] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"'))) << i;
+        masks[JSMN_SKIP_SLOW] |=
+                (uint64_t)(uint32_t)_mm256_movemask_epi8(slow) << i;
+        masks[JSMN_SKIP_OPEN] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(b, _mm256_set1_epi8('['))) << i;
+        masks[JSMN_SKIP_CLOSE] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(b, _mm256_set1_epi8(']'))) << i;
     }
-    return factory->toknext;
 }
 
-int jsmn_append_string(jsmn_Factory *factory, const char *name,
-        const char *value)
+/**
+ * Bit masks of a block of 64 bytes used to count tokens.
+ */
+enum {
+    JSMN_COUNT_QUOTE = 0,
+    // Backslashes and NUL bytes, the block is looked at byte by byte
+    JSMN_COUNT_SLOW = 1,
+    JSMN_COUNT_OPEN = 2,
+    // Whitespace, ',', ':', ']' and '}', which end a primitive
+    JSMN_COUNT_DELIM = 3,
+    // Bytes a primitive may start with in strict mode
+    JSMN_COUNT_START = 4,
+    JSMN_COUNT_CLASSES = 5
+};
+
+static void jsmn_classify_count_sse2(const char *block, uint64_t *masks)
 {
-    return jsmn_append_simple(factory, JSMN_STRING, name, value);
+    int i;
+    masks[JSMN_COUNT_QUOTE] = 0;
+    masks[JSMN_COUNT_SLOW] = 0;
+    masks[JSMN_COUNT_OPEN] = 0;
+    masks[JSMN_COUNT_DELIM] = 0;
+    masks[JSMN_COUNT_START] = 0;
+    for (i = 0; i < JSMN_INDEX_BLOCK; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(block + i));
+        // '[' and ']' are 0x5b and 0x5d, '{' and '}' are 0x7b and 0x7d
+        __m128i b = _mm_andnot_si128(_mm_set1_epi8(0x20), v);
+        __m128i slow = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')),
+                _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+        __m128i delim = _mm_or_si128(
+                _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))),
+                _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(',')),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8(':'))),
+                        _mm_cmpeq_epi8(b, _mm_set1_epi8(']'))));
+        masks[JSMN_COUNT_QUOTE] |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(v, _mm_set1_epi8('\"'))) << i;
+        masks[JSMN_COUNT_SLOW] |=
+                (uint64_t)(uint16_t)_mm_movemask_epi8(slow) << i;
+        masks[JSMN_COUNT_OPEN] |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(b, _mm_set1_epi8('['))) << i;
+        masks[JSMN_COUNT_DELIM] |=
+                (uint64_t)(uint16_t)_mm_movemask_epi8(delim) << i;
+#ifdef JSMN_STRICT
+        masks[JSMN_COUNT_START] |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_or_si128(
+                        _mm_or_si128(
+                                _mm_and_si128(
+                                        _mm_cmpgt_epi8(v, _mm_set1_epi8('/')),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8(':'))),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('-'))),
+                        _mm_or_si128(
+                                _mm_or_si128(
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8('t')),
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8('f'))),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('n'))))) << i;
+#endif
+    }
 }
 
-int jsmn_append_primitive(jsmn_Factory *factory, const char *name,
-        const char *value)
+__attribute__((target("avx2")))
+static void jsmn_classify_count_avx2(const char *block, uint64_t *masks)
 {
-    return jsmn_append_simple(factory, JSMN_PRIMITIVE, name, value);
+    int i;
+    masks[JSMN_COUNT_QUOTE] = 0;
+    masks[JSMN_COUNT_SLOW] = 0;
+    masks[JSMN_COUNT_OPEN] = 0;
+    masks[JSMN_COUNT_DELIM] = 0;
+    masks[JSMN_COUNT_START] = 0;
+    for (i = 0; i < JSMN_INDEX_BLOCK; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(block + i));
+        __m256i b = _mm256_andnot_si256(_mm256_set1_epi8(0x20), v);
+        __m256i slow = _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')),
+                _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+        __m256i delim = _mm256_or_si256(
+                _mm256_or_si256(
+                        _mm256_or_si256(
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                        _mm256_or_si256(
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')))),
+                _mm256_or_si256(
+                        _mm256_or_si256(
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(':'))),
+                        _mm256_cmpeq_epi8(b, _mm256_set1_epi8(']'))));
+        masks[JSMN_COUNT_QUOTE] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\"'))) << i;
+        masks[JSMN_COUNT_SLOW] |=
+                (uint64_t)(uint32_t)_mm256_movemask_epi8(slow) << i;
+        masks[JSMN_COUNT_OPEN] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(b, _mm256_set1_epi8('['))) << i;
+        masks[JSMN_COUNT_DELIM] |=
+                (uint64_t)(uint32_t)_mm256_movemask_epi8(delim) << i;
+#ifdef JSMN_STRICT
+        masks[JSMN_COUNT_START] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_or_si256(
+                        _mm256_or_si256(
+                                _mm256_and_si256(
+                                        _mm256_cmpgt_epi8(v,
+                                                _mm256_set1_epi8('/')),
+                                        _mm256_cmpgt_epi8(
+                                                _mm256_set1_epi8(':'), v)),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-'))),
+                        _mm256_or_si256(
+                                _mm256_or_si256(
+                                        _mm256_cmpeq_epi8(v,
+                                                _mm256_set1_epi8('t')),
+                                        _mm256_cmpeq_epi8(v,
+                                                _mm256_set1_epi8('f'))),
+                                _mm256_cmpeq_epi8(v,
+                                        _mm256_set1_epi8('n'))))) << i;
+#endif
+    }
 }
 
-int jsmn_dump(jsmn_Token *t, jsmn_write_handle_t cb) {
-    if (t->type == JSMN_PRIMITIVE) {
-        cb(t->data, t->length);
-        return 1;
-    } else if (t->type == JSMN_LABEL || t->type == JSMN_STRING) {
-        cb("\"", 1);
-        if (t->length > 0) {
-            cb(t->data, t->length);
-        }
-        cb("\":", t->type == JSMN_LABEL ? 2 : 1);
-        return 1;
-    } else if (t->type == JSMN_OBJECT) {
-        int i;
-        int j = 0;
-        cb("{", 1);
-        for (i = 0; i < t->size; i++) {
-            j += jsmn_dump(t + 1 + j, cb);
-            j += jsmn_dump(t + 1 + j, cb);
-            if (i < t->size - 1) {
-                cb(",", 1);
-            }
-        }
-        cb("}", 1);
-        return j + 1;
-    } else if (t->type == JSMN_ARRAY) {
-        int i;
-        int j = 0;
-        cb("[", 1);
-        for (i = 0; i < t->size; i++) {
-            j += jsmn_dump(t + 1 + j, cb);
-            if (i < t->size - 1) {
-                cb(",", 1);
+#ifdef JSMN_STRICT
+/**
+ * Checks whether the bytes from 'pos' up to 'end' are valid UTF-8. Runs of
+ * ASCII are skipped 16 bytes at a time.
+ */
+static int jsmn_utf8_valid_sse2(const char *js, size_t pos, size_t end,
+        size_t len)
+{
+    const unsigned char *s = (const unsigned char *)js;
+    (void)len;
+    while (pos < end) {
+        int n;
+        if (s[pos] < 0x80) {
+            while (pos + 16 <= end && _mm_movemask_epi8(
+                    _mm_loadu_si128((const __m128i *)(s + pos))) == 0) {
+                pos += 16;
+            }
+            while (pos < end && s[pos] < 0x80) {
+                pos++;
             }
+            continue;
+        }
+        n = jsmn_utf8_sequence(s + pos, end - pos);
+        if (n == 0) {
+            return 0;
         }
-        cb("]", 1);
-        return j + 1;
+        pos += n;
     }
-    return 0;
+    return 1;
 }
 
-void jsmn_parser_init(jsmn_Parser *parser, jsmn_Token *toks, size_t len) {
-    jsmn_factory_init((jsmn_Factory *)parser, toks, len);
-    parser->js = NULL;
-    parser->pos = 0;
+/**
+ * Errors of pairs of bytes, looked up by the high and low nibble of the first
+ * byte and the high nibble of the second one. A pair is invalid, if all three
+ * lookups have a common bit (Keiser and Lemire, "Validating UTF-8 In Less
+ * Than One Instruction Per Byte").
+ */
+enum {
+    JSMN_UTF8_TOO_SHORT = 0x01,     // lead byte not followed by continuation
+    JSMN_UTF8_TOO_LONG = 0x02,      // continuation after ASCII
+    JSMN_UTF8_OVERLONG_3 = 0x04,
+    JSMN_UTF8_TOO_LARGE = 0x08,     // beyond U+10FFFF
+    JSMN_UTF8_SURROGATE = 0x10,
+    JSMN_UTF8_OVERLONG_2 = 0x20,
+    JSMN_UTF8_TOO_LARGE_1000 = 0x40,
+    JSMN_UTF8_OVERLONG_4 = 0x40,
+    JSMN_UTF8_TWO_CONTS = 0x80,     // continuation after continuation
+    JSMN_UTF8_CARRY = JSMN_UTF8_TOO_SHORT | JSMN_UTF8_TOO_LONG |
+            JSMN_UTF8_TWO_CONTS
+};
+
+/**
+ * Returns the errors of the 32 bytes 'v' preceded by the bytes 'prev'.
+ */
+__attribute__((target("avx2")))
+static __m256i jsmn_utf8_check_avx2(__m256i v, __m256i prev)
+{
+    const __m256i byte1_high = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+            JSMN_UTF8_TOO_LONG, JSMN_UTF8_TOO_LONG, JSMN_UTF8_TOO_LONG,
+            JSMN_UTF8_TOO_LONG, JSMN_UTF8_TOO_LONG, JSMN_UTF8_TOO_LONG,
+            JSMN_UTF8_TOO_LONG, JSMN_UTF8_TOO_LONG,
+            JSMN_UTF8_TWO_CONTS, JSMN_UTF8_TWO_CONTS, JSMN_UTF8_TWO_CONTS,
+            JSMN_UTF8_TWO_CONTS,
+            JSMN_UTF8_TOO_SHORT | JSMN_UTF8_OVERLONG_2,
+            JSMN_UTF8_TOO_SHORT,
+            JSMN_UTF8_TOO_SHORT | JSMN_UTF8_OVERLONG_3 | JSMN_UTF8_SURROGATE,
+            JSMN_UTF8_TOO_SHORT | JSMN_UTF8_TOO_LARGE |
+                    JSMN_UTF8_TOO_LARGE_1000 | JSMN_UTF8_OVERLONG_4));
+    const __m256i byte1_low = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+            JSMN_UTF8_CARRY | JSMN_UTF8_OVERLONG_3 | JSMN_UTF8_OVERLONG_2 |
+                    JSMN_UTF8_OVERLONG_4,
+            JSMN_UTF8_CARRY | JSMN_UTF8_OVERLONG_2,
+            JSMN_UTF8_CARRY,
+            JSMN_UTF8_CARRY,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000 |
+                    JSMN_UTF8_SURROGATE,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000,
+            JSMN_UTF8_CARRY | JSMN_UTF8_TOO_LARGE | JSMN_UTF8_TOO_LARGE_1000));
+    const __m256i byte2_high = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+            JSMN_UTF8_TOO_SHORT, JSMN_UTF8_TOO_SHORT, JSMN_UTF8_TOO_SHORT,
+            JSMN_UTF8_TOO_SHORT, JSMN_UTF8_TOO_SHORT, JSMN_UTF8_TOO_SHORT,
+            JSMN_UTF8_TOO_SHORT, JSMN_UTF8_TOO_SHORT,
+            JSMN_UTF8_TOO_LONG | JSMN_UTF8_OVERLONG_2 | JSMN_UTF8_TWO_CONTS |
+                    JSMN_UTF8_OVERLONG_3 | JSMN_UTF8_TOO_LARGE_1000 |
+                    JSMN_UTF8_OVERLONG_4,
+            JSMN_UTF8_TOO_LONG | JSMN_UTF8_OVERLONG_2 | JSMN_UTF8_TWO_CONTS |
+                    JSMN_UTF8_OVERLONG_3 | JSMN_UTF8_TOO_LARGE,
+            JSMN_UTF8_TOO_LONG | JSMN_UTF8_OVERLONG_2 | JSMN_UTF8_TWO_CONTS |
+                    JSMN_UTF8_SURROGATE | JSMN_UTF8_TOO_LARGE,
+            JSMN_UTF8_TOO_LONG | JSMN_UTF8_OVERLONG_2 | JSMN_UTF8_TWO_CONTS |
+                    JSMN_UTF8_SURROGATE | JSMN_UTF8_TOO_LARGE,
+            JSMN_UTF8_TOO_SHORT, JSMN_UTF8_TOO_SHORT, JSMN_UTF8_TOO_SHORT,
+            JSMN_UTF8_TOO_SHORT));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    // The bytes before each byte of 'v', the first ones taken from 'prev'
+    __m256i carry = _mm256_permute2x128_si256(prev, v, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(v, carry, 15);
+    __m256i prev2 = _mm256_alignr_epi8(v, carry, 14);
+    __m256i prev3 = _mm256_alignr_epi8(v, carry, 13);
+    __m256i errors = _mm256_and_si256(_mm256_and_si256(
+            _mm256_shuffle_epi8(byte1_high, _mm256_and_si256(
+                    _mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(byte1_low, _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(byte2_high, _mm256_and_si256(
+                    _mm256_srli_epi16(v, 4), nibble)));
+    // Third and fourth bytes of sequences have to be continuations, which
+    // the pairs above take for TWO_CONTS errors.
+    __m256i must23 = _mm256_or_si256(
+            _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80)),
+            _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80)));
+    return _mm256_xor_si256(errors,
+            _mm256_and_si256(must23, _mm256_set1_epi8(0x80)));
 }
 
 /**
- * Fills next available token with JSON primitive.
+ * Checks whether the bytes from 'pos' up to 'end' are valid UTF-8, 32 bytes
+ * at a time. The bytes up to 'len' may be read.
  */
-static int jsmn_parse_primitive(jsmn_Parser *parser, const char *js,
-        size_t len) {
-    jsmn_Token *token;
-    jsmn_Factory *factory = (jsmn_Factory *)parser;
-    int start = parser->pos;
+__attribute__((target("avx2")))
+static int jsmn_utf8_valid_avx2(const char *js, size_t pos, size_t end,
+        size_t len)
+{
+    // Last bytes of a block which start a sequence not ending in the block
+    const __m256i max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, 0xf0 - 1, 0xe0 - 1, 0xc0 - 1);
+    const __m256i index = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+            11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26,
+            27, 28, 29, 30, 31);
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    __m256i errors = _mm256_setzero_si256();
+    char tail[32];
 
-    for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
-        switch (js[parser->pos]) {
-            // In strict mode primitive must be followed by "," or "}" or "]"
-            case '\t' : case '\r' : case '\n' : case ' ' :
-            case ','  : case ']'  : case '}' :
-                goto found;
+    for (; pos < end; pos += 32) {
+        __m256i v;
+        if (pos + 32 <= len) {
+            v = _mm256_loadu_si256((const __m256i *)(js + pos));
+        } else {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, js + pos, len - pos);
+            v = _mm256_loadu_si256((const __m256i *)tail);
         }
-        if (js[parser->pos] < 32 || js[parser->pos] >= 127) {
-            parser->pos = start;
-            return JSMN_ERROR_INVAL;
+        if (pos + 32 > end) {
+            // Clear the bytes after the end, they pass as ASCII
+            v = _mm256_and_si256(v, _mm256_cmpgt_epi8(
+                    _mm256_set1_epi8((char)(end - pos)), index));
         }
+        if (_mm256_movemask_epi8(v) == 0) {
+            errors = _mm256_or_si256(errors, incomplete);
+        } else {
+            errors = _mm256_or_si256(errors, jsmn_utf8_check_avx2(v, prev));
+            incomplete = _mm256_subs_epu8(v, max);
+        }
+        prev = v;
     }
-    // In strict mode primitive must be followed by a comma/object/array
-    parser->pos = start;
-    return JSMN_ERROR_PART;
-
-found:
-    if (factory->toks == NULL) {
-        parser->pos--;
-        return 0;
-    }
-    token = jsmn_alloc_token(factory, 1);
-    if (token == NULL) {
-        parser->pos = start;
-        return JSMN_ERROR_NOMEM;
-    }
-    jsmn_fill_token(token, JSMN_PRIMITIVE, js, start, parser->pos);
-    token->parent = factory->toksuper;
-    parser->pos--;
-    return 0;
+    errors = _mm256_or_si256(errors, incomplete);
+    return _mm256_testz_si256(errors, errors);
 }
+#endif
 
 /**
- * Fills next token with JSON string.
+ * One set of implementations of the SIMD kernels.
  */
-static int jsmn_parse_string(jsmn_Parser *parser, const char *js, size_t len) {
-    jsmn_Token *token;
-    jsmn_Factory *factory = (jsmn_Factory *)parser;
-    int start = parser->pos;
+typedef struct jsmn_Simd {
+    void (*classify)(const char *block, uint64_t *masks);
+    size_t (*scan_string)(const char *js, size_t pos, size_t len);
+    size_t (*scan_escape)(const char *js, size_t pos, size_t len);
+    void (*classify_skip)(const char *block, uint64_t *masks);
+    void (*classify_count)(const char *block, uint64_t *masks);
+#ifdef JSMN_STRICT
+    int (*utf8_valid)(const char *js, size_t pos, size_t end, size_t len);
+#endif
+} jsmn_Simd;
 
-    parser->pos++;
+static const jsmn_Simd jsmn_simd_avx2 = {
+    jsmn_classify_avx2,
+    jsmn_scan_string_avx2,
+    jsmn_scan_escape_avx2,
+    jsmn_classify_skip_avx2,
+    jsmn_classify_count_avx2,
+#ifdef JSMN_STRICT
+    jsmn_utf8_valid_avx2,
+#endif
+};
 
-    // Skip starting quote
-    for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
-        char c = js[parser->pos];
+static const jsmn_Simd jsmn_simd_sse2 = {
+    jsmn_classify_sse2,
+    jsmn_scan_string_sse2,
+    jsmn_scan_escape_sse2,
+    jsmn_classify_skip_sse2,
+    jsmn_classify_count_sse2,
+#ifdef JSMN_STRICT
+    jsmn_utf8_valid_sse2,
+#endif
+};
 
-        // Quote: end of string
-        if (c == '\"') {
-            jsmntype_t type;
-            if (factory->toks == NULL) {
-                return 0;
-            }
-            token = jsmn_alloc_token(factory, 1);
-            if (token == NULL) {
-                parser->pos = start;
-                return JSMN_ERROR_NOMEM;
-            }
-            // Check wheter string is a label or an ordinary value
-            type = JSMN_STRING;
-            if (factory->toks[factory->toksuper].type == JSMN_OBJECT) {
-                type = JSMN_LABEL;
-            }
-            jsmn_fill_token(token, type, js, start+1, parser->pos);
-            token->parent = factory->toksuper;
-            return 0;
-        }
+// The tables are constant, so threads racing on the first call all publish
+// the same pointer and a relaxed load is enough to use it
+static const jsmn_Simd *jsmn_simd_impl;
 
-        // Backslash: Quoted symbol expected
-        if (c == '\\' && parser->pos + 1 < len) {
-            int i;
-            parser->pos++;
-            switch (js[parser->pos]) {
+/**
+ * Returns the widest implementations supported by the CPU.
+ */
+static inline const jsmn_Simd *jsmn_simd(void)
+{
+    const jsmn_Simd *simd = __atomic_load_n(&jsmn_simd_impl,
+            __ATOMIC_RELAXED);
+    if (simd == NULL) {
+        simd = __builtin_cpu_supports("avx2") ? &jsmn_simd_avx2
+                                              : &jsmn_simd_sse2;
+        __atomic_store_n(&jsmn_simd_impl, simd, __ATOMIC_RELAXED);
+    }
+    return simd;
+}
+
+#define jsmn_classify (jsmn_simd()->classify)
+#define jsmn_scan_string (jsmn_simd()->scan_string)
+#define jsmn_scan_escape (jsmn_simd()->scan_escape)
+#define jsmn_classify_skip (jsmn_simd()->classify_skip)
+#define jsmn_classify_count (jsmn_simd()->classify_count)
+#ifdef JSMN_STRICT
+#define jsmn_utf8_valid (jsmn_simd()->utf8_valid)
+#endif
+
+static void jsmn_index_init(jsmn_Index *ix, const char *js, size_t len)
+{
+    ix->js = js;
+    ix->len = len;
+    // Force a load on the first lookup
+    ix->base = (size_t)-1 - JSMN_INDEX_BLOCK;
+}
+
+/**
+ * Classifies the block starting at 'pos'.
+ */
+static void jsmn_index_load(jsmn_Index *ix, size_t pos)
+{
+    size_t n = ix->len - pos;
+    ix->base = pos;
+    if (n >= JSMN_INDEX_BLOCK) {
+        jsmn_classify(ix->js + pos, ix->masks);
+    } else {
+        // Do not read beyond the end of the JSON string
+        char block[JSMN_INDEX_BLOCK];
+        uint64_t end = ~(uint64_t)0 << n;
+        int i;
+        memcpy(block, ix->js + pos, n);
+        memset(block + n, ' ', JSMN_INDEX_BLOCK - n);
+        jsmn_classify(block, ix->masks);
+        for (i = 0; i < JSMN_INDEX_CLASSES; i++) {
+            ix->masks[i] |= end;
+        }
+    }
+}
+
+/**
+ * Returns the position of the next byte of the given class at or after 'pos',
+ * or the length of the JSON string if there is none.
+ */
+static inline unsigned int jsmn_index_next(jsmn_Index *ix, unsigned int pos,
+        int cls)
+{
+    for (;;) {
+        uint64_t mask;
+        if (pos - ix->base >= JSMN_INDEX_BLOCK) {
+            if (pos >= ix->len) {
+                return pos;
+            }
+            jsmn_index_load(ix, pos);
+        }
+        mask = ix->masks[cls] >> (pos - ix->base);
+        if (mask != 0) {
+            return pos + __builtin_ctzll(mask);
+        }
+        pos = ix->base + JSMN_INDEX_BLOCK;
+    }
+}
+
+/**
+ * Returns the position of the next quote, backslash or NUL byte at or after
+ * 'pos'. Runs of plain characters beyond the current block are skipped by the
+ * string scanner rather than by classifying every block.
+ */
+static inline unsigned int jsmn_index_string(jsmn_Index *ix, unsigned int pos)
+{
+    if (pos - ix->base < JSMN_INDEX_BLOCK) {
+        uint64_t mask = ix->masks[JSMN_INDEX_STRING] >> (pos - ix->base);
+        if (mask != 0) {
+            return pos + __builtin_ctzll(mask);
+        }
+        pos = ix->base + JSMN_INDEX_BLOCK;
+    }
+    if (pos >= ix->len) {
+        return pos;
+    }
+    return jsmn_scan_string(ix->js, pos, ix->len);
+}
+
+/**
+ * Returns the position after the object or array starting at 'pos', found by
+ * balancing the brackets outside of strings. Strings are found by a prefix
+ * XOR over the quotes of a block, blocks with backslashes or NUL bytes are
+ * looked at byte by byte.
+ */
+static int jsmn_skip_container(const char *js, size_t len, size_t pos)
+{
+    jsmn_Skip skip = { 0, 0, 0 };
+    uint64_t masks[JSMN_SKIP_CLASSES];
+    uint64_t string = 0;
+    int r;
+
+    for (; pos < len; pos += JSMN_INDEX_BLOCK) {
+        uint64_t inside;
+        uint64_t brackets;
+        size_t n = len - pos;
+        if (n >= JSMN_INDEX_BLOCK) {
+            jsmn_classify_skip(js + pos, masks);
+        } else {
+            char block[JSMN_INDEX_BLOCK];
+            memcpy(block, js + pos, n);
+            memset(block + n, ' ', JSMN_INDEX_BLOCK - n);
+            jsmn_classify_skip(block, masks);
+        }
+        if (masks[JSMN_SKIP_SLOW] != 0 || skip.escaped) {
+            skip.string = string != 0;
+            r = jsmn_skip_bytes(&skip, js, pos,
+                    pos + (n < JSMN_INDEX_BLOCK ? n : JSMN_INDEX_BLOCK));
+            if (r != 0) {
+                return r;
+            }
+            string = skip.string ? ~(uint64_t)0 : 0;
+            continue;
+        }
+        // Bytes from an opening quote up to the closing one
+        inside = masks[JSMN_SKIP_QUOTE];
+        inside ^= inside << 1;
+        inside ^= inside << 2;
+        inside ^= inside << 4;
+        inside ^= inside << 8;
+        inside ^= inside << 16;
+        inside ^= inside << 32;
+        inside ^= string;
+        brackets = (masks[JSMN_SKIP_OPEN] | masks[JSMN_SKIP_CLOSE]) & ~inside;
+        while (brackets != 0) {
+            int i = __builtin_ctzll(brackets);
+            if (masks[JSMN_SKIP_OPEN] & ((uint64_t)1 << i)) {
+                skip.depth++;
+            } else if (--skip.depth == 0) {
+                return pos + i + 1;
+            }
+            brackets &= brackets - 1;
+        }
+        string = (uint64_t)((int64_t)inside >> 63);
+    }
+    return JSMN_ERROR_PART;
+}
+
+/**
+ * Counts the tokens from 'pos' up to 'len' without looking at every byte:
+ * strings are found by a prefix XOR over the quotes of a block, objects and
+ * arrays by their opening brackets and primitives by the first byte of a run
+ * of other bytes. Blocks with backslashes are looked at byte by byte.
+ *
+ * Nothing but the token boundaries and, in strict mode, the grammar of the
+ * primitives is checked. Returns the number of tokens, or -1 if the parser
+ * has to count them, e.g. at a NUL byte, at an invalid primitive or if the
+ * data ends within a string or primitive.
+ */
+static int jsmn_count_tokens(const char *js, size_t pos, size_t len)
+{
+    jsmn_Count cnt = { 0, 0, 0, 0 };
+    uint64_t masks[JSMN_COUNT_CLASSES];
+    uint64_t string = 0;
+    uint64_t primitive = 0;
+
+    for (; pos + JSMN_INDEX_BLOCK <= len; pos += JSMN_INDEX_BLOCK) {
+        uint64_t inside;
+        uint64_t prim;
+        uint64_t after;
+        uint64_t open;
+        uint64_t starts;
+        if (string != 0 && !cnt.escaped) {
+            // Continue at the end of a long string
+            size_t end = jsmn_scan_string(js, pos, len);
+            if (end + JSMN_INDEX_BLOCK > len) {
+                break;
+            }
+            pos = end;
+        }
+        jsmn_classify_count(js + pos, masks);
+        if (masks[JSMN_COUNT_SLOW] != 0 || cnt.escaped) {
+            cnt.string = string != 0;
+            cnt.primitive = primitive != 0;
+            if (jsmn_count_bytes(&cnt, js, pos, pos + JSMN_INDEX_BLOCK,
+                    len) < 0) {
+                return -1;
+            }
+            string = cnt.string ? ~(uint64_t)0 : 0;
+            primitive = cnt.primitive;
+            continue;
+        }
+        // Bytes from an opening quote up to the closing one
+        inside = masks[JSMN_COUNT_QUOTE];
+        inside ^= inside << 1;
+        inside ^= inside << 2;
+        inside ^= inside << 4;
+        inside ^= inside << 8;
+        inside ^= inside << 16;
+        inside ^= inside << 32;
+        inside ^= string;
+        prim = ~inside & ~(masks[JSMN_COUNT_QUOTE] | masks[JSMN_COUNT_OPEN] |
+                masks[JSMN_COUNT_DELIM]);
+        // Bytes following a byte of a primitive
+        after = prim << 1 | primitive;
+        open = (masks[JSMN_COUNT_OPEN] & ~inside) |
+                (masks[JSMN_COUNT_QUOTE] & inside);
+        starts = prim & ~after;
+        if ((open & after) != 0) {
+            return -1;
+        }
+        cnt.count += __builtin_popcountll(open) +
+                __builtin_popcountll(starts);
+#ifdef JSMN_STRICT
+        if ((starts & ~masks[JSMN_COUNT_START]) != 0) {
+            return -1;
+        }
+        // Let the parser reject invalid primitives
+        for (; starts != 0; starts &= starts - 1) {
+            if (!jsmn_count_primitive(js, pos + __builtin_ctzll(starts),
+                    len)) {
+                return -1;
+            }
+        }
+#endif
+        string = (uint64_t)((int64_t)inside >> 63);
+        primitive = prim >> 63;
+    }
+    cnt.string = string != 0;
+    cnt.primitive = primitive != 0;
+    if (jsmn_count_bytes(&cnt, js, pos, len, len) < 0 ||
+            cnt.string || cnt.primitive) {
+        return -1;
+    }
+    return cnt.count;
+}
+
+/**
+ * Checks whether the four bytes at 'p' are all hex digits.
+ */
+static inline int jsmn_is_hex4(const char *p)
+{
+    uint32_t x;
+    uint32_t lower;
+    uint32_t digit;
+    uint32_t alpha;
+    memcpy(&x, p, 4);
+    // Per byte range checks, only valid for ASCII bytes
+    lower = (x | 0x20202020) & 0x7f7f7f7f;
+    digit = (0xb9b9b9b9 - (x & 0x7f7f7f7f)) & ~x &
+            ((x & 0x7f7f7f7f) + 0x50505050);
+    alpha = (0xe6e6e6e6 - lower) & ~lower & (lower + 0x1f1f1f1f);
+    return (x & 0x80808080) == 0 &&
+            ((digit | alpha) & 0x80808080) == 0x80808080;
+}
+
+#else
+
+// Without SIMD support every byte is looked at by the parser loops
+typedef int jsmn_Index;
+#define jsmn_index_init(ix, js, len) ((void)(ix))
+#define jsmn_index_next(ix, pos, cls) ((void)(ix), (pos))
+#define jsmn_index_string(ix, pos) ((void)(ix), (pos))
+
+static size_t jsmn_scan_string(const char *js, size_t pos, size_t len)
+{
+    for (; pos < len; pos++) {
+        if (js[pos] == '\"' || js[pos] == '\\' || js[pos] == '\0') {
+            break;
+        }
+    }
+    return pos;
+}
+
+static size_t jsmn_scan_escape(const char *js, size_t pos, size_t len)
+{
+    for (; pos < len; pos++) {
+        if (js[pos] == '\"' || js[pos] == '\\' ||
+                (unsigned char)js[pos] < 0x20) {
+            break;
+        }
+    }
+    return pos;
+}
+
+static int jsmn_skip_container(const char *js, size_t len, size_t pos)
+{
+    jsmn_Skip skip = { 0, 0, 0 };
+    int r = jsmn_skip_bytes(&skip, js, pos, len);
+    return r == 0 ? JSMN_ERROR_PART : r;
+}
+
+static int jsmn_count_tokens(const char *js, size_t pos, size_t len)
+{
+    jsmn_Count cnt = { 0, 0, 0, 0 };
+    if (jsmn_count_bytes(&cnt, js, pos, len, len) < 0 ||
+            cnt.string || cnt.primitive) {
+        return -1;
+    }
+    return cnt.count;
+}
+
+#ifdef JSMN_STRICT
+static int jsmn_utf8_valid(const char *js, size_t pos, size_t end,
+        size_t len)
+{
+    const unsigned char *s = (const unsigned char *)js;
+    (void)len;
+    while (pos < end) {
+        int n = 1;
+        if (s[pos] >= 0x80) {
+            n = jsmn_utf8_sequence(s + pos, end - pos);
+            if (n == 0) {
+                return 0;
+            }
+        }
+        pos += n;
+    }
+    return 1;
+}
+#endif
+
+#endif
+
+#define JSMN_TOKENS_MIN 16
+
+/**
+ * Grows the token array geometrically to hold at least 'len' tokens.
+ */
+static int jsmn_grow_tokens(jsmn_Factory *factory, size_t len) {
+    jsmn_Token *toks;
+    size_t n = factory->tokslen > 0 ? factory->tokslen : JSMN_TOKENS_MIN;
+    if (factory->alloc == NULL) {
+        return JSMN_ERROR_NOMEM;
+    }
+    while (n < len) {
+        n *= 2;
+    }
+    toks = factory->alloc->grow(factory->alloc->ctx, factory->toks, n);
+    if (toks == NULL) {
+        return JSMN_ERROR_NOMEM;
+    }
+    factory->toks = toks;
+    factory->tokslen = n;
+    return 0;
+}
+
+/**
+ * Returns the innermost open object or array of a factory or -1.
+ */
+static inline int jsmn_open_top(const jsmn_Factory *factory) {
+    if (factory->depth == 0) {
+        return -1;
+    }
+    return factory->depth <= JSMN_MAX_DEPTH ?
+            factory->stack[factory->depth - 1] : factory->open;
+}
+
+/**
+ * Opens the object or array 'c'. Beyond the stack the 'length' of its token,
+ * which is only set once it is closed, links it to the enclosing one.
+ */
+static inline void jsmn_open_push(jsmn_Factory *factory, int c) {
+    if (factory->depth < JSMN_MAX_DEPTH) {
+        factory->stack[factory->depth] = c;
+    } else {
+        factory->toks[c].length = jsmn_open_top(factory);
+        factory->open = c;
+    }
+    factory->depth++;
+}
+
+/**
+ * Closes the innermost open object or array, returns the one enclosing it or
+ * -1.
+ */
+static inline int jsmn_open_pop(jsmn_Factory *factory) {
+    if (factory->depth > JSMN_MAX_DEPTH) {
+        jsmn_Token *t = &factory->toks[factory->open];
+        factory->open = t->length;
+        t->length = -1;
+    }
+    factory->depth--;
+    return jsmn_open_top(factory);
+}
+
+/**
+ * Without a token array and an allocator the parser only counts tokens.
+ */
+static int jsmn_is_counting(const jsmn_Factory *factory) {
+    return factory->toks == NULL && factory->alloc == NULL;
+}
+
+/**
+ * Allocates a fresh unused token from the token pull.
+ */
+static jsmn_Token *jsmn_alloc_token(jsmn_Factory *factory, size_t len) {
+    int i;
+    jsmn_Token *tok;
+    if (factory->toknext + (len - 1) >= factory->tokslen) {
+        // Grow the token array, if there is an allocator
+        if (jsmn_grow_tokens(factory, factory->toknext + len) < 0) {
+            return NULL;
+        }
+    }
+    for (i = 0; i < len; i++) {
+        tok = factory->toks + factory->toknext++;
+        tok->type = JSMN_UNDEFINED;
+        tok->flags = 0;
+#ifndef JSMN_COMPACT_TOKENS
+        tok->data = NULL;
+#endif
+        tok->start = 0;
+        tok->length = -1;
+        tok->size = 0;
+#ifdef JSMN_PARENT_LINKS
+        tok->parent = -1;
+#endif
+        tok->next = factory->toknext;
+    }
+    return tok - (len - 1);
+}
+
+/**
+ * Fills token type and boundaries.
+ */
+static void jsmn_fill_token(jsmn_Token *token, jsmntype_t type, const char *js,
+                            unsigned int base, int start, int end) {
+    token->type = type;
+#ifndef JSMN_COMPACT_TOKENS
+    token->data = js + start;
+#else
+    (void)js;
+#endif
+    token->start = base + start;
+    token->length = end - start;
+    token->size = 0;
+}
+
+/**
+ * Counts a new child of the superior token and moves the end of its subtree
+ * behind the tokens allocated so far. Fails, if the size does not fit into a
+ * compact token.
+ */
+static inline int jsmn_add_child(jsmn_Factory *factory) {
+    jsmn_Token *super = &factory->toks[factory->toksuper];
+#ifdef JSMN_COMPACT_TOKENS
+    if (super->size == JSMN_COMPACT_SIZE_MAX) {
+        return -1;
+    }
+#endif
+    super->size++;
+    super->next = factory->toknext;
+    return 0;
+}
+
+/**
+ * Returns the superior token of the open object or array 'c' enclosed by the
+ * open one 'outer', i.e. its label, the array it is an element of or -1 at
+ * the root.
+ */
+static inline int jsmn_container_super(const jsmn_Factory *factory, int c,
+        int outer)
+{
+#ifdef JSMN_PARENT_LINKS
+    (void)outer;
+    return factory->toks[c].parent;
+#else
+    // A label, or whatever a colon made superior, directly precedes its
+    // value. Objects and arrays before it are closed siblings.
+    if (c > 0 && factory->toks[c - 1].size > 0 &&
+            factory->toks[c - 1].type != JSMN_OBJECT &&
+            factory->toks[c - 1].type != JSMN_ARRAY) {
+        return c - 1;
+    }
+    return outer;
+#endif
+}
+
+/**
+ * Checks that a token created by the builders can refer to 'data'.
+ */
+static int jsmn_check_data(const jsmn_Factory *factory, const char *data)
+{
+#ifdef JSMN_COMPACT_TOKENS
+    // Compact tokens only store the offset from the base of the factory
+    if (factory->base == NULL || data < factory->base ||
+            (size_t)(data - factory->base) > UINT_MAX) {
+        return -1;
+    }
+#else
+    (void)factory;
+    (void)data;
+#endif
+    return 0;
+}
+
+/**
+ * Sets the data of a token created by the builders, see 'jsmn_check_data'.
+ */
+static void jsmn_set_data(jsmn_Factory *factory, jsmn_Token *token,
+        const char *data)
+{
+#ifdef JSMN_COMPACT_TOKENS
+    token->start = data - factory->base;
+#else
+    (void)factory;
+    token->data = data;
+#endif
+}
+
+void jsmn_factory_init(jsmn_Factory *factory, jsmn_Token *toks, size_t len) {
+    factory->toks = toks;
+    factory->tokslen = len;
+    factory->toknext = 0;
+    factory->toksuper = -1;
+    factory->depth = 0;
+    factory->open = -1;
+    factory->alloc = NULL;
+    factory->chars = NULL;
+    factory->charslen = 0;
+    factory->charnext = 0;
+    factory->arena = 0;
+#ifdef JSMN_COMPACT_TOKENS
+    factory->base = NULL;
+#endif
+}
+
+void jsmn_factory_init_alloc(jsmn_Factory *factory,
+        const jsmn_Allocator *alloc) {
+    jsmn_factory_init(factory, NULL, 0);
+    factory->alloc = alloc;
+}
+
+void jsmn_factory_free(jsmn_Factory *factory) {
+    if (factory->alloc != NULL && factory->toks != NULL) {
+        factory->alloc->free(factory->alloc->ctx, factory->toks);
+    }
+    factory->toks = NULL;
+    factory->tokslen = 0;
+    factory->toknext = 0;
+    factory->toksuper = -1;
+    factory->depth = 0;
+    factory->open = -1;
+}
+
+/**
+ * Room for 'len' characters in the storage of the factory or NULL.
+ */
+static char *jsmn_factory_chars(jsmn_Factory *factory, size_t len)
+{
+    if (factory->charslen - factory->charnext < len) {
+        return NULL;
+    }
+    return factory->chars + factory->charnext;
+}
+
+/**
+ * Copies 'len' characters at 's' into the arena of the factory, if it has
+ * one. Compact tokens cannot refer to characters before their base, those
+ * are copied into the storage as well. Returns where they are kept or NULL
+ * if there is no room left.
+ */
+static const char *jsmn_factory_keep(jsmn_Factory *factory, const char *s,
+        size_t len)
+{
+    char *p;
+    if (s == NULL) {
+        return s;
+    }
+#ifdef JSMN_COMPACT_TOKENS
+    if (!factory->arena && (factory->chars == NULL ||
+            jsmn_check_data(factory, s) == 0)) {
+        return s;
+    }
+#else
+    if (!factory->arena) {
+        return s;
+    }
+#endif
+    p = jsmn_factory_chars(factory, len);
+    if (p == NULL) {
+        return NULL;
+    }
+    memcpy(p, s, len);
+    factory->charnext += len;
+    return p;
+}
+
+/**
+ * Allocates the token to append with a label for 'name' within an object.
+ * Everything which can fail, including whether the token can refer to
+ * 'value', is checked before the factory is changed. Returns 0,
+ * JSMN_ERROR_NOMEM if the arena is full or JSMN_ERROR_FACTORY.
+ */
+static int jsmn_prepare_append(jsmn_Factory *factory, const char *name,
+        size_t namelen, const char *value, jsmn_Token **append)
+{
+    jsmn_Token *token;
+    size_t charnext = factory->charnext;
+    int n_tokens = 1;
+    if (value != NULL && jsmn_check_data(factory, value) < 0) {
+        return JSMN_ERROR_FACTORY;
+    }
+    // Does the append going to be within a supertoken 
+    if (factory->toksuper != -1) {
+#ifdef JSMN_COMPACT_TOKENS
+        if (factory->toks[factory->toksuper].size == JSMN_COMPACT_SIZE_MAX) {
+            return JSMN_ERROR_FACTORY;
+        }
+#endif
+        // If the append is with in a object a label token is needed.
+        if (factory->toks[factory->toksuper].type == JSMN_OBJECT) {
+            if (name == NULL || namelen > INT_MAX) {
+                // Exit with an error, if no name for a label token is defined
+                return JSMN_ERROR_FACTORY;
+            }
+            name = jsmn_factory_keep(factory, name, namelen);
+            if (name == NULL) {
+                return JSMN_ERROR_NOMEM;
+            }
+            if (jsmn_check_data(factory, name) < 0) {
+                goto fail;
+            }
+            // Two tokens have to be appended a label and the actual token
+            n_tokens = 2;
+        }
+    }
+    // Allocate the needed tokens
+    token = jsmn_alloc_token(factory, n_tokens);
+    if (token == NULL) {
+        goto fail;
+    }
+    // Increment the size of the supertoken, which cannot fail anymore
+    if (factory->toksuper != -1) {
+        jsmn_add_child(factory);
+    }
+    // Append label token
+    if (n_tokens == 2) {
+        int toklabel = token - factory->toks;
+        token->type = JSMN_LABEL;
+        token->flags = JSMN_FLAG_RAW;
+        jsmn_set_data(factory, token, name);
+        token->length = namelen;
+        token->size = 1;
+        token->next = toklabel + 2;
+#ifdef JSMN_PARENT_LINKS
+        // The parent token of the label will be the current supertoken
+        token->parent = factory->toksuper;
+#endif
+        // Jump the the actual token
+        token++;
+#ifdef JSMN_PARENT_LINKS
+        // The parent of the actual token will be the label token
+        token->parent = toklabel;
+    } else {
+        // Within an array the current supertoken, or -1 as root token
+        token->parent = factory->toksuper;
+#endif
+    }
+    *append = token;
+    return 0;
+fail:
+    // Drop the copy of the name
+    factory->charnext = charnext;
+    return JSMN_ERROR_FACTORY;
+}
+
+static int jsmn_start_sequence(jsmn_Factory *factory, jsmntype_t type,
+        const char *name, size_t namelen)
+{
+    jsmn_Token *token;
+    // Prepare the token
+    int r = jsmn_prepare_append(factory, name, namelen, NULL, &token);
+    if (r < 0) {
+        return r;
+    }
+    // Append object token
+    token->type = type;
+    factory->toksuper = token - factory->toks;
+    jsmn_open_push(factory, factory->toksuper);
+    return factory->toknext;
+}
+
+static int jsmn_end_sequence(jsmn_Factory *factory, jsmntype_t type)
+{
+    int c = jsmn_open_top(factory);
+    int outer;
+    int super;
+    // Check wheter there is a sequence (object or array) to end
+    if (c == -1) {
+        return JSMN_ERROR_FACTORY;
+    }
+    // Check the type of the to be ended sequence
+    if (factory->toks[c].type != type) {
+        return JSMN_ERROR_FACTORY;
+    }
+    outer = jsmn_open_pop(factory);
+    factory->toks[c].next = factory->toknext;
+    // The subtree of its label or array ends here as well
+    super = jsmn_container_super(factory, c, outer);
+    if (super != -1) {
+        factory->toks[super].next = factory->toknext;
+    }
+    // Continue with the enclosing sequence, if there is one
+    factory->toksuper = outer;
+    return factory->toknext;
+}
+
+int jsmn_start_object(jsmn_Factory *factory, const char *name)
+{
+    return jsmn_start_sequence(factory, JSMN_OBJECT, name,
+            name != NULL ? strlen(name) : 0);
+}
+
+int jsmn_start_object_len(jsmn_Factory *factory, const char *name,
+        size_t namelen)
+{
+    return jsmn_start_sequence(factory, JSMN_OBJECT, name, namelen);
+}
+
+int jsmn_end_object(jsmn_Factory *factory)
+{
+    return jsmn_end_sequence(factory, JSMN_OBJECT);
+}
+
+int jsmn_start_array(jsmn_Factory *factory, const char *name)
+{
+    return jsmn_start_sequence(factory, JSMN_ARRAY, name,
+            name != NULL ? strlen(name) : 0);
+}
+
+int jsmn_start_array_len(jsmn_Factory *factory, const char *name,
+        size_t namelen)
+{
+    return jsmn_start_sequence(factory, JSMN_ARRAY, name, namelen);
+}
+
+int jsmn_end_array(jsmn_Factory *factory)
+{
+    return jsmn_end_sequence(factory, JSMN_ARRAY);
+}
+
+static int jsmn_append_simple(jsmn_Factory *factory, jsmntype_t type,
+        const char *name, size_t namelen, const char *value, size_t len)
+{
+    jsmn_Token *token;
+    size_t charnext = factory->charnext;
+    int r;
+    if (len > INT_MAX) {
+        return JSMN_ERROR_FACTORY;
+    }
+    // Keep the value before the tokens are added
+    if (value != NULL) {
+        value = jsmn_factory_keep(factory, value, len);
+        if (value == NULL) {
+            return JSMN_ERROR_NOMEM;
+        }
+    }
+    // Prepare the token
+    r = jsmn_prepare_append(factory, name, namelen, value, &token);
+    if (r < 0) {
+        // Drop the copy of the value
+        factory->charnext = charnext;
+        return r;
+    }
+    // Append the data to the string or primitive token
+    token->type = type;
+    if (value != NULL) {
+        jsmn_set_data(factory, token, value);
+        token->length = len;
+        // Strings are plain text, they are escaped when dumped
+        if (type == JSMN_PRIMITIVE) {
+            token->flags = jsmn_classify_primitive(value, token->length) << 1;
+        } else {
+            token->flags = JSMN_FLAG_RAW;
+        }
+    }
+    return factory->toknext;
+}
+
+int jsmn_append_string(jsmn_Factory *factory, const char *name,
+        const char *value)
+{
+    return jsmn_append_simple(factory, JSMN_STRING, name,
+            name != NULL ? strlen(name) : 0, value,
+            value != NULL ? strlen(value) : 0);
+}
+
+int jsmn_append_string_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, const char *value, size_t len)
+{
+    return jsmn_append_simple(factory, JSMN_STRING, name, namelen, value, len);
+}
+
+int jsmn_append_primitive(jsmn_Factory *factory, const char *name,
+        const char *value)
+{
+    return jsmn_append_simple(factory, JSMN_PRIMITIVE, name,
+            name != NULL ? strlen(name) : 0, value,
+            value != NULL ? strlen(value) : 0);
+}
+
+int jsmn_append_primitive_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, const char *value, size_t len)
+{
+    return jsmn_append_simple(factory, JSMN_PRIMITIVE, name, namelen, value,
+            len);
+}
+
+void jsmn_factory_storage(jsmn_Factory *factory, char *buf, size_t len)
+{
+    factory->chars = buf;
+    factory->charslen = len;
+    factory->charnext = 0;
+    factory->arena = 0;
+#ifdef JSMN_COMPACT_TOKENS
+    if (factory->base == NULL) {
+        factory->base = buf;
+    }
+#endif
+}
+
+void jsmn_factory_arena(jsmn_Factory *factory, char *buf, size_t len)
+{
+    jsmn_factory_storage(factory, buf, len);
+    factory->arena = 1;
+}
+
+void jsmn_factory_reset(jsmn_Factory *factory)
+{
+    factory->toknext = 0;
+    factory->toksuper = -1;
+    factory->depth = 0;
+    factory->charnext = 0;
+}
+
+/**
+ * Appends a primitive of 'length' characters at 'value' of the given kind.
+ * The first 'stored' of them have been written to the free characters of the
+ * storage, they are only taken if the primitive is appended.
+ */
+static int jsmn_append_kind(jsmn_Factory *factory, const char *name,
+        size_t namelen, const char *value, int length, int stored,
+        jsmnkind_t kind)
+{
+    jsmn_Token *token;
+    int r;
+    factory->charnext += stored;
+    r = jsmn_prepare_append(factory, name, namelen, value, &token);
+    if (r < 0) {
+        factory->charnext -= stored;
+        return r;
+    }
+    jsmn_set_data(factory, token, value);
+    token->type = JSMN_PRIMITIVE;
+    token->length = length;
+    token->flags = kind << 1;
+    return factory->toknext;
+}
+
+/**
+ * Pairs of decimal digits of 0 to 99.
+ */
+static const char jsmn_digits[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * Writes the decimal digits of 'value' to 'buf', two at a time from the end.
+ * Returns the number of digits, up to 20.
+ */
+static int jsmn_format_uint64(char *buf, uint64_t value)
+{
+    char tmp[20];
+    char *p = tmp + sizeof(tmp);
+    int n;
+
+    while (value >= 100) {
+        unsigned int i = (unsigned int)(value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        p[0] = jsmn_digits[i];
+        p[1] = jsmn_digits[i + 1];
+    }
+    if (value >= 10) {
+        p -= 2;
+        p[0] = jsmn_digits[value * 2];
+        p[1] = jsmn_digits[value * 2 + 1];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    n = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, n);
+    return n;
+}
+
+/**
+ * Floating point number with a 64 bit significand: f * 2^e.
+ */
+typedef struct {
+    uint64_t f;
+    int e;
+} jsmn_Fp;
+
+/**
+ * Normalised powers 10^(-348 + 8 * i), the steps are small enough for the
+ * product with any double to fall into the range Grisu needs.
+ */
+static const jsmn_Fp jsmn_powers[] = {
+    { 0xfa8fd5a0081c0288ULL, -1220 },
+    { 0xbaaee17fa23ebf76ULL, -1193 },
+    { 0x8b16fb203055ac76ULL, -1166 },
+    { 0xcf42894a5dce35eaULL, -1140 },
+    { 0x9a6bb0aa55653b2dULL, -1113 },
+    { 0xe61acf033d1a45dfULL, -1087 },
+    { 0xab70fe17c79ac6caULL, -1060 },
+    { 0xff77b1fcbebcdc4fULL, -1034 },
+    { 0xbe5691ef416bd60cULL, -1007 },
+    { 0x8dd01fad907ffc3cULL, -980 },
+    { 0xd3515c2831559a83ULL, -954 },
+    { 0x9d71ac8fada6c9b5ULL, -927 },
+    { 0xea9c227723ee8bcbULL, -901 },
+    { 0xaecc49914078536dULL, -874 },
+    { 0x823c12795db6ce57ULL, -847 },
+    { 0xc21094364dfb5637ULL, -821 },
+    { 0x9096ea6f3848984fULL, -794 },
+    { 0xd77485cb25823ac7ULL, -768 },
+    { 0xa086cfcd97bf97f4ULL, -741 },
+    { 0xef340a98172aace5ULL, -715 },
+    { 0xb23867fb2a35b28eULL, -688 },
+    { 0x84c8d4dfd2c63f3bULL, -661 },
+    { 0xc5dd44271ad3cdbaULL, -635 },
+    { 0x936b9fcebb25c996ULL, -608 },
+    { 0xdbac6c247d62a584ULL, -582 },
+    { 0xa3ab66580d5fdaf6ULL, -555 },
+    { 0xf3e2f893dec3f126ULL, -529 },
+    { 0xb5b5ada8aaff80b8ULL, -502 },
+    { 0x87625f056c7c4a8bULL, -475 },
+    { 0xc9bcff6034c13053ULL, -449 },
+    { 0x964e858c91ba2655ULL, -422 },
+    { 0xdff9772470297ebdULL, -396 },
+    { 0xa6dfbd9fb8e5b88fULL, -369 },
+    { 0xf8a95fcf88747d94ULL, -343 },
+    { 0xb94470938fa89bcfULL, -316 },
+    { 0x8a08f0f8bf0f156bULL, -289 },
+    { 0xcdb02555653131b6ULL, -263 },
+    { 0x993fe2c6d07b7facULL, -236 },
+    { 0xe45c10c42a2b3b06ULL, -210 },
+    { 0xaa242499697392d3ULL, -183 },
+    { 0xfd87b5f28300ca0eULL, -157 },
+    { 0xbce5086492111aebULL, -130 },
+    { 0x8cbccc096f5088ccULL, -103 },
+    { 0xd1b71758e219652cULL, -77 },
+    { 0x9c40000000000000ULL, -50 },
+    { 0xe8d4a51000000000ULL, -24 },
+    { 0xad78ebc5ac620000ULL, 3 },
+    { 0x813f3978f8940984ULL, 30 },
+    { 0xc097ce7bc90715b3ULL, 56 },
+    { 0x8f7e32ce7bea5c70ULL, 83 },
+    { 0xd5d238a4abe98068ULL, 109 },
+    { 0x9f4f2726179a2245ULL, 136 },
+    { 0xed63a231d4c4fb27ULL, 162 },
+    { 0xb0de65388cc8ada8ULL, 189 },
+    { 0x83c7088e1aab65dbULL, 216 },
+    { 0xc45d1df942711d9aULL, 242 },
+    { 0x924d692ca61be758ULL, 269 },
+    { 0xda01ee641a708deaULL, 295 },
+    { 0xa26da3999aef774aULL, 322 },
+    { 0xf209787bb47d6b85ULL, 348 },
+    { 0xb454e4a179dd1877ULL, 375 },
+    { 0x865b86925b9bc5c2ULL, 402 },
+    { 0xc83553c5c8965d3dULL, 428 },
+    { 0x952ab45cfa97a0b3ULL, 455 },
+    { 0xde469fbd99a05fe3ULL, 481 },
+    { 0xa59bc234db398c25ULL, 508 },
+    { 0xf6c69a72a3989f5cULL, 534 },
+    { 0xb7dcbf5354e9beceULL, 561 },
+    { 0x88fcf317f22241e2ULL, 588 },
+    { 0xcc20ce9bd35c78a5ULL, 614 },
+    { 0x98165af37b2153dfULL, 641 },
+    { 0xe2a0b5dc971f303aULL, 667 },
+    { 0xa8d9d1535ce3b396ULL, 694 },
+    { 0xfb9b7cd9a4a7443cULL, 720 },
+    { 0xbb764c4ca7a44410ULL, 747 },
+    { 0x8bab8eefb6409c1aULL, 774 },
+    { 0xd01fef10a657842cULL, 800 },
+    { 0x9b10a4e5e9913129ULL, 827 },
+    { 0xe7109bfba19c0c9dULL, 853 },
+    { 0xac2820d9623bf429ULL, 880 },
+    { 0x80444b5e7aa7cf85ULL, 907 },
+    { 0xbf21e44003acdd2dULL, 933 },
+    { 0x8e679c2f5e44ff8fULL, 960 },
+    { 0xd433179d9c8cb841ULL, 986 },
+    { 0x9e19db92b4e31ba9ULL, 1013 },
+    { 0xeb96bf6ebadf77d9ULL, 1039 },
+    { 0xaf87023b9bf0ee6bULL, 1066 }
+};
+
+static jsmn_Fp jsmn_fp_mul(jsmn_Fp x, jsmn_Fp y)
+{
+    const uint64_t m32 = 0xffffffff;
+    uint64_t a = x.f >> 32, b = x.f & m32, c = y.f >> 32, d = y.f & m32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    // Round the lower half
+    uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1U << 31);
+    jsmn_Fp r;
+    r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+/**
+ * Moves the last digit towards the exact value while it stays within the
+ * bounds, so the shortest output is also the closest one.
+ */
+static void jsmn_grisu_round(char *buf, int len, uint64_t delta,
+        uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+            (rest + ten_kappa < wp_w ||
+             wp_w - rest > rest + ten_kappa - wp_w)) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/**
+ * Shortest digits of the positive finite 'value' (Grisu2 by Florian Loitsch,
+ * as in RapidJSON). The value is 'buf' * 10^'*k'. Returns the number of
+ * digits, up to 17.
+ */
+static int jsmn_grisu2(double value, char *buf, int *k)
+{
+    static const uint64_t pow10[] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL,
+        100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+        10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+        100000000000000000ULL, 1000000000000000000ULL,
+        10000000000000000000ULL };
+    const uint64_t hidden = (uint64_t)1 << 52;
+    jsmn_Fp v, w, plus, minus, c, one, wp_w;
+    uint64_t bits, delta, p2;
+    uint32_t p1;
+    double dk;
+    int kappa;
+    int len = 0;
+    int i;
+
+    memcpy(&bits, &value, sizeof(bits));
+    v.f = bits & (hidden - 1);
+    v.e = (int)(bits >> 52 & 0x7ff);
+    if (v.e != 0) {
+        v.f += hidden;
+        v.e -= 1075;
+    } else {
+        v.e = -1074;
+    }
+    // Boundaries halfway to the neighbouring doubles, the lower one is
+    // closer at powers of two
+    plus.f = (v.f << 1) + 1;
+    plus.e = v.e - 1;
+    while (!(plus.f & (hidden << 1))) {
+        plus.f <<= 1;
+        plus.e--;
+    }
+    plus.f <<= 10;
+    plus.e -= 10;
+    if (v.f == hidden) {
+        minus.f = (v.f << 2) - 1;
+        minus.e = v.e - 2;
+    } else {
+        minus.f = (v.f << 1) - 1;
+        minus.e = v.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+    w = v;
+    i = __builtin_clzll(w.f);
+    w.f <<= i;
+    w.e -= i;
+    // Cached power bringing the exponent of the upper boundary to [-60, -32]
+    dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+    i = (int)dk;
+    if (dk - i > 0.0) {
+        i++;
+    }
+    i = (i >> 3) + 1;
+    *k = -(-348 + i * 8);
+    c = jsmn_powers[i];
+    w = jsmn_fp_mul(w, c);
+    plus = jsmn_fp_mul(plus, c);
+    minus = jsmn_fp_mul(minus, c);
+    minus.f++;
+    plus.f--;
+    delta = plus.f - minus.f;
+
+    // Digits of the integral part of the upper boundary
+    one.f = (uint64_t)1 << -plus.e;
+    one.e = plus.e;
+    wp_w.f = plus.f - w.f;
+    p1 = (uint32_t)(plus.f >> -one.e);
+    p2 = plus.f & (one.f - 1);
+    for (kappa = 1; kappa < 10 && p1 >= pow10[kappa]; kappa++);
+    while (kappa > 0) {
+        uint32_t d = p1 / (uint32_t)pow10[kappa - 1];
+        p1 %= (uint32_t)pow10[kappa - 1];
+        if (d != 0 || len != 0) {
+            buf[len++] = (char)('0' + d);
+        }
+        kappa--;
+        if (((uint64_t)p1 << -one.e) + p2 <= delta) {
+            *k += kappa;
+            jsmn_grisu_round(buf, len, delta, ((uint64_t)p1 << -one.e) + p2,
+                    pow10[kappa] << -one.e, wp_w.f);
+            return len;
+        }
+    }
+    // Digits of the fractional part
+    for (;;) {
+        char d;
+        p2 *= 10;
+        delta *= 10;
+        d = (char)(p2 >> -one.e);
+        if (d != 0 || len != 0) {
+            buf[len++] = (char)('0' + d);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            jsmn_grisu_round(buf, len, delta, p2, one.f,
+                    -kappa < 20 ? wp_w.f * pow10[-kappa] : 0);
+            return len;
+        }
+    }
+}
+
+/**
+ * Writes the finite 'value' as a JSON number with a fraction or exponent.
+ * Returns its length, up to 25 characters.
+ */
+static int jsmn_format_double(char *buf, double value)
+{
+    char *p = buf;
+    uint64_t bits;
+    int len;
+    int k;
+    int kk;
+
+    memcpy(&bits, &value, sizeof(bits));
+    if (bits >> 63) {
+        *p++ = '-';
+        value = -value;
+    }
+    if (value == 0) {
+        memcpy(p, "0.0", 3);
+        return p + 3 - buf;
+    }
+    len = jsmn_grisu2(value, p, &k);
+    // The value is between 10^(kk - 1) and 10^kk
+    kk = len + k;
+    if (k >= 0 && kk <= 21) {
+        // 1234e7 -> 12340000000.0
+        memset(p + len, '0', k);
+        memcpy(p + kk, ".0", 2);
+        return p + kk + 2 - buf;
+    } else if (kk > 0 && kk <= 21) {
+        // 1234e-2 -> 12.34
+        memmove(p + kk + 1, p + kk, len - kk);
+        p[kk] = '.';
+        return p + len + 1 - buf;
+    } else if (kk > -6 && kk <= 0) {
+        // 1234e-6 -> 0.001234
+        memmove(p + 2 - kk, p, len);
+        p[0] = '0';
+        p[1] = '.';
+        memset(p + 2, '0', -kk);
+        return p + len + 2 - kk - buf;
+    }
+    // 1234e30 -> 1.234e+33
+    if (len > 1) {
+        memmove(p + 2, p + 1, len - 1);
+        p[1] = '.';
+        len++;
+    }
+    p += len;
+    *p++ = 'e';
+    *p++ = kk - 1 < 0 ? '-' : '+';
+    return p + jsmn_format_uint64(p, kk - 1 < 0 ? 1 - kk : kk - 1) - buf;
+}
+
+int jsmn_append_int64(jsmn_Factory *factory, const char *name, int64_t value)
+{
+    return jsmn_append_int64_len(factory, name,
+            name != NULL ? strlen(name) : 0, value);
+}
+
+int jsmn_append_int64_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, int64_t value)
+{
+    char *p = jsmn_factory_chars(factory, 20);
+    int n;
+
+    if (p == NULL) {
+        return JSMN_ERROR_NOMEM;
+    }
+    if (value < 0) {
+        p[0] = '-';
+        n = 1 + jsmn_format_uint64(p + 1, -(uint64_t)value);
+    } else {
+        n = jsmn_format_uint64(p, value);
+    }
+    return jsmn_append_kind(factory, name, namelen, p, n, n,
+            JSMN_KIND_INTEGER);
+}
+
+int jsmn_append_uint64(jsmn_Factory *factory, const char *name,
+        uint64_t value)
+{
+    return jsmn_append_uint64_len(factory, name,
+            name != NULL ? strlen(name) : 0, value);
+}
+
+int jsmn_append_uint64_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, uint64_t value)
+{
+    char *p = jsmn_factory_chars(factory, 20);
+    int n;
+
+    if (p == NULL) {
+        return JSMN_ERROR_NOMEM;
+    }
+    n = jsmn_format_uint64(p, value);
+    return jsmn_append_kind(factory, name, namelen, p, n, n,
+            JSMN_KIND_INTEGER);
+}
+
+int jsmn_append_double(jsmn_Factory *factory, const char *name, double value)
+{
+    return jsmn_append_double_len(factory, name,
+            name != NULL ? strlen(name) : 0, value);
+}
+
+int jsmn_append_double_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, double value)
+{
+    char *p = jsmn_factory_chars(factory, 25);
+    uint64_t bits;
+    int n;
+
+    // Infinity and NaN have all bits of the exponent set
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits >> 52 & 0x7ff) == 0x7ff) {
+        return JSMN_ERROR_INVAL;
+    }
+    if (p == NULL) {
+        return JSMN_ERROR_NOMEM;
+    }
+    n = jsmn_format_double(p, value);
+    return jsmn_append_kind(factory, name, namelen, p, n, n,
+            JSMN_KIND_FLOAT);
+}
+
+/**
+ * Appends one of the literals true, false and null.
+ */
+static int jsmn_append_literal(jsmn_Factory *factory, const char *name,
+        size_t namelen, const char *value, int length, jsmnkind_t kind)
+{
+#ifdef JSMN_COMPACT_TOKENS
+    // The literal has to be within reach of the base of the offsets
+    char *p = jsmn_factory_chars(factory, length);
+    if (p == NULL) {
+        return JSMN_ERROR_NOMEM;
+    }
+    memcpy(p, value, length);
+    return jsmn_append_kind(factory, name, namelen, p, length, length, kind);
+#else
+    return jsmn_append_kind(factory, name, namelen, value, length, 0, kind);
+#endif
+}
+
+int jsmn_append_bool(jsmn_Factory *factory, const char *name, int value)
+{
+    return jsmn_append_bool_len(factory, name,
+            name != NULL ? strlen(name) : 0, value);
+}
+
+int jsmn_append_bool_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, int value)
+{
+    if (value) {
+        return jsmn_append_literal(factory, name, namelen, "true", 4,
+                JSMN_KIND_TRUE);
+    }
+    return jsmn_append_literal(factory, name, namelen, "false", 5,
+            JSMN_KIND_FALSE);
+}
+
+int jsmn_append_null(jsmn_Factory *factory, const char *name)
+{
+    return jsmn_append_null_len(factory, name,
+            name != NULL ? strlen(name) : 0);
+}
+
+int jsmn_append_null_len(jsmn_Factory *factory, const char *name,
+        size_t namelen)
+{
+    return jsmn_append_literal(factory, name, namelen, "null", 4,
+            JSMN_KIND_NULL);
+}
+
+void jsmn_writer_init(jsmn_Writer *writer, char *buf, size_t size,
+        jsmn_sink_handle_t sink, void *ctx)
+{
+    writer->sink = sink;
+    writer->ctx = ctx;
+    writer->buf = buf;
+    writer->size = size;
+    writer->len = 0;
+    writer->error = 0;
+}
+
+static int jsmn_writer_sink(jsmn_Writer *writer, const jsmn_Fragment *frags,
+        int count)
+{
+    int r = writer->sink(writer->ctx, frags, count);
+    if (r < 0) {
+        writer->error = r;
+    }
+    return writer->error;
+}
+
+int jsmn_writer_write(jsmn_Writer *writer, const char *data, size_t length)
+{
+    size_t n = writer->size - writer->len;
+    jsmn_Fragment frags[2];
+
+    if (writer->error < 0) {
+        return writer->error;
+    }
+    if (length <= n) {
+        memcpy(writer->buf + writer->len, data, length);
+        writer->len += length;
+        return 0;
+    }
+    if (writer->sink == NULL) {
+        writer->error = JSMN_ERROR_NOMEM;
+        return writer->error;
+    }
+    frags[0].data = writer->buf;
+    frags[0].length = writer->len;
+    if (length >= writer->size) {
+        // Too large to be buffered, it is passed on without copying
+        frags[1].data = data;
+        frags[1].length = length;
+        writer->len = 0;
+        return jsmn_writer_sink(writer, frags, 2);
+    }
+    // Fill up the buffer, so the sink gets blocks of its size
+    memcpy(writer->buf + writer->len, data, n);
+    frags[0].length = writer->size;
+    writer->len = 0;
+    if (jsmn_writer_sink(writer, frags, 1) < 0) {
+        return writer->error;
+    }
+    memcpy(writer->buf, data + n, length - n);
+    writer->len = length - n;
+    return 0;
+}
+
+int jsmn_writer_flush(jsmn_Writer *writer)
+{
+    jsmn_Fragment frag;
+
+    if (writer->error < 0 || writer->len == 0 || writer->sink == NULL) {
+        return writer->error;
+    }
+    frag.data = writer->buf;
+    frag.length = writer->len;
+    writer->len = 0;
+    return jsmn_writer_sink(writer, &frag, 1);
+}
+
+int jsmn_sink_memory(void *ctx, const jsmn_Fragment *frags, int count)
+{
+    int i;
+    for (i = 0; i < count; i++) {
+        if (jsmn_writer_write(ctx, frags[i].data, frags[i].length) < 0) {
+            return ((jsmn_Writer *)ctx)->error;
+        }
+    }
+    return 0;
+}
+
+#ifdef JSMN_HOSTED
+int jsmn_sink_file(void *ctx, const jsmn_Fragment *frags, int count)
+{
+    int i;
+    for (i = 0; i < count; i++) {
+        if (fwrite(frags[i].data, 1, frags[i].length, ctx) != frags[i].length) {
+            return JSMN_ERROR_IO;
+        }
+    }
+    return 0;
+}
+#endif
+
+#ifdef JSMN_POSIX
+int jsmn_sink_fd(void *ctx, const jsmn_Fragment *frags, int count)
+{
+    struct iovec iov[2];
+    ssize_t r;
+    int i = 0;
+    int n;
+
+    for (n = 0; n < count && n < 2; n++) {
+        iov[n].iov_base = (void *)frags[n].data;
+        iov[n].iov_len = frags[n].length;
+    }
+    while (i < n) {
+        r = writev(*(int *)ctx, iov + i, n - i);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return JSMN_ERROR_IO;
+        }
+        // Skip what has been written and resume with the rest
+        while (i < n && (size_t)r >= iov[i].iov_len) {
+            r -= iov[i].iov_len;
+            i++;
+        }
+        if (i < n) {
+            iov[i].iov_base = (char *)iov[i].iov_base + r;
+            iov[i].iov_len -= r;
+        }
+    }
+    return 0;
+}
+#endif
+
+/**
+ * Writes to the buffer of the writer, only calling out when it is full.
+ */
+static inline void jsmn_put(jsmn_Writer *writer, const char *data,
+        size_t length)
+{
+    if (writer->size - writer->len >= length) {
+        memcpy(writer->buf + writer->len, data, length);
+        writer->len += length;
+    } else {
+        jsmn_writer_write(writer, data, length);
+    }
+}
+
+/**
+ * Writes plain text escaped as the content of a JSON string. Runs without
+ * special characters are found by SIMD and copied as a whole.
+ */
+static void jsmn_put_escaped(jsmn_Writer *writer, const char *s, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    char esc[6] = { '\\', 'u', '0', '0' };
+    size_t pos = 0;
+    size_t end;
+
+    while ((end = jsmn_scan_escape(s, pos, len)) < len) {
+        unsigned char c = s[end];
+        jsmn_put(writer, s + pos, end - pos);
+        switch (c) {
+            case '\"': case '\\': esc[1] = c; break;
+            case '\b': esc[1] = 'b'; break;
+            case '\f': esc[1] = 'f'; break;
+            case '\n': esc[1] = 'n'; break;
+            case '\r': esc[1] = 'r'; break;
+            case '\t': esc[1] = 't'; break;
+            default:
+                esc[1] = 'u';
+                esc[4] = hex[c >> 4];
+                esc[5] = hex[c & 0xf];
+                jsmn_put(writer, esc, 6);
+                pos = end + 1;
+                continue;
+        }
+        jsmn_put(writer, esc, 2);
+        pos = end + 1;
+    }
+    jsmn_put(writer, s + pos, len - pos);
+}
+
+/**
+ * Writes a string or label token in quotes.
+ */
+static void jsmn_put_string(const char *js, const jsmn_Token *t,
+        jsmn_Writer *writer)
+{
+    jsmn_put(writer, "\"", 1);
+    if (t->length > 0 && (t->flags & JSMN_FLAG_RAW)) {
+        jsmn_put_escaped(writer, jsmn_token_data(js, t), t->length);
+    } else if (t->length > 0) {
+        jsmn_put(writer, jsmn_token_data(js, t), t->length);
+    }
+    jsmn_put(writer, "\"", 1);
+}
+
+int jsmn_dump_writer(const char *js, jsmn_Token *t, jsmn_Writer *writer)
+{
+    return jsmn_serialize(js, t, writer, 0);
+}
+
+/**
+ * Sink of 'jsmn_dump_js' calling its write handler.
+ */
+typedef struct {
+    jsmn_write_handle_t cb;
+} jsmn_Handler;
+
+static int jsmn_sink_handler(void *ctx, const jsmn_Fragment *frags,
+        int count)
+{
+    jsmn_Handler *handler = ctx;
+    int i;
+    for (i = 0; i < count; i++) {
+        if (frags[i].length > 0 &&
+                handler->cb(frags[i].data, frags[i].length) < 0) {
+            return JSMN_ERROR_IO;
+        }
+    }
+    return 0;
+}
+
+int jsmn_dump_js(const char *js, jsmn_Token *t, jsmn_write_handle_t cb)
+{
+    char buf[256];
+    jsmn_Handler handler;
+    jsmn_Writer writer;
+    int r;
+
+    // The handler is called once the buffer is full, not for each fragment
+    handler.cb = cb;
+    jsmn_writer_init(&writer, buf, sizeof(buf), jsmn_sink_handler, &handler);
+    r = jsmn_dump_writer(js, t, &writer);
+    if (jsmn_writer_flush(&writer) < 0) {
+        return writer.error;
+    }
+    return r;
+}
+
+#ifndef JSMN_COMPACT_TOKENS
+int jsmn_dump(jsmn_Token *t, jsmn_write_handle_t cb)
+{
+    // The tokens point to their data
+    return jsmn_dump_js(NULL, t, cb);
+}
+#endif
+
+/**
+ * Starts a new line indented to 'depth' levels.
+ */
+static void jsmn_put_indent(jsmn_Writer *writer, int indent, int depth)
+{
+    static const char spaces[] = "                                ";
+    size_t n = (size_t)indent * depth;
+    jsmn_put(writer, "\n", 1);
+    while (n > 0) {
+        size_t k = n < sizeof(spaces) - 1 ? n : sizeof(spaces) - 1;
+        jsmn_put(writer, spaces, k);
+        n -= k;
+    }
+}
+
+/**
+ * Serialises the value 't' at 'level' of the whole value. Each call keeps up
+ * to JSMN_MAX_DEPTH open objects and arrays on its stack, deeper ones are
+ * serialised by another call.
+ */
+static int jsmn_serialize_level(const char *js, jsmn_Token *t,
+        jsmn_Writer *writer, int indent, int level)
+{
+    int left[JSMN_MAX_DEPTH]; // members or elements left in the outer levels
+    char close[JSMN_MAX_DEPTH];
+    int depth = 0;
+    int n = 0; // members or elements left in the innermost level
+    int i = 0;
+    int r;
+
+    for (;;) {
+        const jsmn_Token *tok = t + i++;
+        if (tok->type == JSMN_PRIMITIVE) {
+            jsmn_put(writer, jsmn_token_data(js, tok), tok->length);
+        } else if (tok->type == JSMN_STRING) {
+            jsmn_put_string(js, tok, writer);
+        } else if (tok->type == JSMN_LABEL) {
+            jsmn_put_string(js, tok, writer);
+            jsmn_put(writer, ": ", indent > 0 ? 2 : 1);
+            continue;
+        } else if (tok->type == JSMN_OBJECT || tok->type == JSMN_ARRAY) {
+            if (tok->size == 0) {
+                jsmn_put(writer, tok->type == JSMN_OBJECT ? "{}" : "[]", 2);
+            } else if (depth == JSMN_MAX_DEPTH) {
+                r = jsmn_serialize_level(js, t + i - 1, writer, indent,
+                        level + depth);
+                if (r < 0) {
+                    return r;
+                }
+                i += r - 1;
+            } else {
+                jsmn_put(writer, tok->type == JSMN_OBJECT ? "{" : "[", 1);
+                left[depth] = n;
+                close[depth] = tok->type == JSMN_OBJECT ? '}' : ']';
+                depth++;
+                n = tok->size;
+                if (indent > 0) {
+                    jsmn_put_indent(writer, indent, level + depth);
+                }
+                continue;
+            }
+        } else {
+            return JSMN_ERROR_INVAL;
+        }
+        // A value is complete, separate the next one or close the
+        // containers completed by it
+        for (;;) {
+            if (depth == 0) {
+                return writer->error < 0 ? writer->error : i;
+            }
+            if (--n > 0) {
+                jsmn_put(writer, ",", 1);
+                if (indent > 0) {
+                    jsmn_put_indent(writer, indent, level + depth);
+                }
+                break;
+            }
+            depth--;
+            n = left[depth];
+            if (indent > 0) {
+                jsmn_put_indent(writer, indent, level + depth);
+            }
+            jsmn_put(writer, &close[depth], 1);
+        }
+    }
+}
+
+int jsmn_serialize(const char *js, jsmn_Token *t, jsmn_Writer *writer,
+        int indent)
+{
+    return jsmn_serialize_level(js, t, writer, indent, 0);
+}
+
+/**
+ * What the strict parser accepts next.
+ */
+enum {
+    JSMN_EXPECT_VALUE = 0x01,
+    JSMN_EXPECT_KEY = 0x02,
+    JSMN_EXPECT_COLON = 0x04,
+    // A comma between members or elements
+    JSMN_EXPECT_COMMA = 0x08,
+    // The end of the innermost object or array
+    JSMN_EXPECT_CLOSE = 0x10
+};
+
+#ifdef JSMN_STRICT
+/**
+ * Returns what the strict parser accepts after a complete value.
+ */
+static inline unsigned int jsmn_after_value(const jsmn_Parser *parser)
+{
+    return parser->factory.depth == 0 ? JSMN_EXPECT_VALUE :
+            JSMN_EXPECT_COMMA | JSMN_EXPECT_CLOSE;
+}
+
+/**
+ * Returns what the strict parser accepts after a key or string value.
+ */
+static inline unsigned int jsmn_after_string(const jsmn_Parser *parser)
+{
+    return parser->expect & JSMN_EXPECT_KEY ? JSMN_EXPECT_COLON :
+            jsmn_after_value(parser);
+}
+#endif
+
+void jsmn_parser_init(jsmn_Parser *parser, jsmn_Token *toks, size_t len) {
+    jsmn_factory_init((jsmn_Factory *)parser, toks, len);
+    parser->js = NULL;
+    parser->pos = 0;
+    parser->base = 0;
+    parser->expect = JSMN_EXPECT_VALUE;
+    parser->tokpart = JSMN_UNDEFINED;
+    parser->tokstart = 0;
+    parser->tokflags = 0;
+}
+
+void jsmn_parser_init_alloc(jsmn_Parser *parser, const jsmn_Allocator *alloc)
+{
+    jsmn_parser_init(parser, NULL, 0);
+    parser->factory.alloc = alloc;
+}
+
+/**
+ * Fills next available token with the JSON primitive from 'start' up to the
+ * current position.
+ */
+static int jsmn_end_primitive(jsmn_Parser *parser, const char *js,
+        int start) {
+    jsmn_Token *token;
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmnkind_t kind = jsmn_classify_primitive(js + start, parser->pos - start);
+
+#ifdef JSMN_STRICT
+    if (kind == JSMN_KIND_INVALID) {
+        parser->pos = start;
+        return JSMN_ERROR_INVAL;
+    }
+#endif
+    if (jsmn_is_counting(factory)) {
+        return 0;
+    }
+    token = jsmn_alloc_token(factory, 1);
+    if (token == NULL) {
+        parser->pos = start;
+        return JSMN_ERROR_NOMEM;
+    }
+    jsmn_fill_token(token, JSMN_PRIMITIVE, js, parser->base, start,
+            parser->pos);
+    token->flags = kind << 1;
+#ifdef JSMN_PARENT_LINKS
+    token->parent = factory->toksuper;
+#endif
+    return 0;
+}
+
+/**
+ * Fills next available token with JSON primitive.
+ *
+ * 'start' is the position of the first character. A primitive cut off by the
+ * end of the data is continued by the next call at 'parser->pos'.
+ */
+static int jsmn_parse_primitive(jsmn_Parser *parser, jsmn_Index *ix,
+        const char *js, size_t len, int start) {
+#ifndef JSMN_STRICT
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+#endif
+    int r;
+
+    parser->tokpart = JSMN_UNDEFINED;
+    for (; parser->pos < len; parser->pos++) {
+        // Skip the valid characters of the primitive
+        parser->pos = jsmn_index_next(ix, parser->pos, JSMN_INDEX_PRIMITIVE);
+        if (parser->pos >= len || js[parser->pos] == '\0') {
+            break;
+        }
+        switch (js[parser->pos]) {
+            // Primitives end at whitespace, ",", "]", "}" and at ":", which
+            // only follows keys in permissive mode
+            case '\t' : case '\r' : case '\n' : case ' ' :
+            case ','  : case ']'  : case '}'  : case ':' :
+                goto found;
+        }
+        if (js[parser->pos] < 32 || js[parser->pos] >= 127) {
+            parser->pos = start;
+            return JSMN_ERROR_INVAL;
+        }
+    }
+#ifndef JSMN_STRICT
+    // In permissive mode the data ends a primitive at the root
+    if (factory->depth == 0 &&
+            (parser->pos >= len || js[parser->pos] == '\0')) {
+        goto found;
+    }
+#endif
+    // In strict mode primitive must be followed by a comma/object/array
+    parser->tokpart = JSMN_PRIMITIVE;
+    parser->tokstart = start;
+    return JSMN_ERROR_PART;
+
+found:
+    r = jsmn_end_primitive(parser, js, start);
+    if (r == 0) {
+        parser->pos--;
+    }
+    return r;
+}
+
+/**
+ * Fills next token with JSON string.
+ *
+ * 'start' is the position of the opening quote. A string cut off by the end
+ * of the data is continued by the next call at 'parser->pos'.
+ */
+static int jsmn_parse_string(jsmn_Parser *parser, jsmn_Index *ix,
+        const char *js, size_t len, int start) {
+    jsmn_Token *token;
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    int escaped = 0;
+
+    if (parser->tokpart == JSMN_STRING) {
+        escaped = (parser->tokflags & JSMN_FLAG_ESCAPED) != 0;
+        parser->tokpart = JSMN_UNDEFINED;
+    } else {
+        // Skip starting quote
+        parser->pos++;
+    }
+
+    for (; parser->pos < len; parser->pos++) {
+        char c;
+        // Jump to the next quote or backslash
+        parser->pos = jsmn_index_string(ix, parser->pos);
+        if (parser->pos >= len || js[parser->pos] == '\0') {
+            break;
+        }
+        c = js[parser->pos];
+
+        // Quote: end of string
+        if (c == '\"') {
+            jsmntype_t type;
+#ifdef JSMN_STRICT
+            if (!jsmn_utf8_valid(js, start + 1, parser->pos, len)) {
+                parser->pos = start;
+                return JSMN_ERROR_INVAL;
+            }
+#endif
+            if (jsmn_is_counting(factory)) {
+                return 0;
+            }
+            token = jsmn_alloc_token(factory, 1);
+            if (token == NULL) {
+                parser->pos = start;
+                return JSMN_ERROR_NOMEM;
+            }
+            // Check wheter string is a label or an ordinary value
+            type = JSMN_STRING;
+            if (factory->toksuper != -1 &&
+                    factory->toks[factory->toksuper].type == JSMN_OBJECT) {
+                type = JSMN_LABEL;
+            }
+            jsmn_fill_token(token, type, js, parser->base, start+1,
+                    parser->pos);
+            if (escaped) {
+                token->flags |= JSMN_FLAG_ESCAPED;
+            }
+#ifdef JSMN_PARENT_LINKS
+            token->parent = factory->toksuper;
+#endif
+            return 0;
+        }
+
+        // Backslash: Quoted symbol expected
+        if (c == '\\') {
+            int i;
+            int backslash = parser->pos;
+            if (parser->pos + 1 >= len) {
+                // Continue at the backslash when the next symbol is there
+                break;
+            }
+            escaped = 1;
+            parser->pos++;
+            switch (js[parser->pos]) {
                 // Allowed escaped symbols
                 case '\"': case '/' : case '\\' : case 'b' :
                 case 'f' : case 'r' : case 'n'  : case 't' :
@@ -318,6 +2712,14 @@ static int jsmn_parse_string(jsmn_Parser *parser, const char *js, size_t len) {
                 // Allows escaped symbol \uXXXX
                 case 'u':
                     parser->pos++;
+#ifdef JSMN_SIMD
+                    // Check all four hex digits at once if they are there
+                    if (parser->pos + 4 <= len &&
+                            jsmn_is_hex4(js + parser->pos)) {
+                        parser->pos += 3;
+                        break;
+                    }
+#endif
                     for(i = 0; i < 4 && parser->pos < len && js[parser->pos] != '\0'; i++) {
                         // If it isn't a hex character we have an error
                         if(!((js[parser->pos] >= 48 && js[parser->pos] <= 57) || /* 0-9 */
@@ -328,6 +2730,11 @@ static int jsmn_parse_string(jsmn_Parser *parser, const char *js, size_t len) {
                         }
                         parser->pos++;
                     }
+                    if (i < 4) {
+                        // Not all hex characters are there yet
+                        parser->pos = backslash;
+                        goto part;
+                    }
                     parser->pos--;
                     break;
                 // Unexpected symbol
@@ -337,131 +2744,3374 @@ static int jsmn_parse_string(jsmn_Parser *parser, const char *js, size_t len) {
             }
         }
     }
-    parser->pos = start;
-    return JSMN_ERROR_PART;
+part:
+    parser->tokpart = JSMN_STRING;
+    parser->tokstart = start;
+    parser->tokflags = escaped ? JSMN_FLAG_ESCAPED : 0;
+    return JSMN_ERROR_PART;
+}
+
+/**
+ * Parses the JSON string from the current position up to 'len' with the
+ * structural index 'ix', which may extend beyond 'len'.
+ */
+static int jsmn_parse_indexed(jsmn_Parser *parser, jsmn_Index *ix,
+        const char *js, size_t len) {
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmn_Token *token;
+    jsmntype_t type;
+    int counting = jsmn_is_counting(factory);
+    int count = factory->toknext;
+    int i;
+    int r;
+
+    // Continue with the string or primitive cut off by the previous call
+    if (parser->tokpart != JSMN_UNDEFINED) {
+        type = parser->tokpart;
+        if (type == JSMN_STRING) {
+            r = jsmn_parse_string(parser, ix, js, len, parser->tokstart);
+        } else {
+            r = jsmn_parse_primitive(parser, ix, js, len, parser->tokstart);
+        }
+        if (r < 0) return r;
+        count++;
+        if (factory->toksuper != -1 && !counting &&
+                jsmn_add_child(factory) < 0)
+            return JSMN_ERROR_NOMEM;
+#ifdef JSMN_STRICT
+        parser->expect = type == JSMN_STRING ? jsmn_after_string(parser) :
+                jsmn_after_value(parser);
+#endif
+        parser->pos++;
+    }
+    // Parse JSON string
+    for (; parser->pos < len; parser->pos++) {
+        char c;
+
+        // Jump straight to the next structural character or value
+        parser->pos = jsmn_index_next(ix, parser->pos, JSMN_INDEX_VALUE);
+        if (parser->pos >= len || js[parser->pos] == '\0') {
+            break;
+        }
+        c = js[parser->pos];
+        switch (c) {
+            case '{': case '[':
+                count++;
+                if (counting) {
+                    break;
+                }
+#ifdef JSMN_STRICT
+                if (!(parser->expect & JSMN_EXPECT_VALUE)) {
+                    return JSMN_ERROR_INVAL;
+                }
+#endif
+                token = jsmn_alloc_token(factory, 1);
+                if (token == NULL)
+                    return JSMN_ERROR_NOMEM;
+                if (factory->toksuper != -1) {
+                    if (jsmn_add_child(factory) < 0)
+                        return JSMN_ERROR_NOMEM;
+#ifdef JSMN_PARENT_LINKS
+                    token->parent = factory->toksuper;
+#endif
+                }
+                token->type = (c == '{' ? JSMN_OBJECT : JSMN_ARRAY);
+#ifndef JSMN_COMPACT_TOKENS
+                token->data = js + parser->pos;
+#endif
+                token->start = parser->base + parser->pos;
+                factory->toksuper = factory->toknext - 1;
+                // Push the container onto the stack of open containers
+                jsmn_open_push(factory, factory->toksuper);
+#ifdef JSMN_STRICT
+                parser->expect = JSMN_EXPECT_CLOSE |
+                        (c == '{' ? JSMN_EXPECT_KEY : JSMN_EXPECT_VALUE);
+#endif
+                break;
+            case '}': case ']':
+                if (counting)
+                    break;
+#ifdef JSMN_STRICT
+                if (!(parser->expect & JSMN_EXPECT_CLOSE)) {
+                    return JSMN_ERROR_INVAL;
+                }
+#endif
+                type = (c == '}' ? JSMN_OBJECT : JSMN_ARRAY);
+                // The innermost open container has to be closed
+                i = jsmn_open_top(factory);
+                if (i == -1 || factory->toks[i].type != type) {
+                    return JSMN_ERROR_INVAL;
+                }
+                token = &factory->toks[i];
+                factory->toksuper = jsmn_container_super(factory, i,
+                        jsmn_open_pop(factory));
+                token->length = parser->base + parser->pos - token->start + 1;
+                token->next = factory->toknext;
+                // The subtree of the label or array ends here as well
+                if (factory->toksuper != -1) {
+                    factory->toks[factory->toksuper].next = factory->toknext;
+                }
+#ifdef JSMN_STRICT
+                parser->expect = jsmn_after_value(parser);
+#endif
+                break;
+            case '\"':
+#ifdef JSMN_STRICT
+                if (!counting && !(parser->expect &
+                        (JSMN_EXPECT_VALUE | JSMN_EXPECT_KEY))) {
+                    return JSMN_ERROR_INVAL;
+                }
+#endif
+                r = jsmn_parse_string(parser, ix, js, len, parser->pos);
+                if (r < 0) return r;
+                count++;
+                if (factory->toksuper != -1 && !counting &&
+                        jsmn_add_child(factory) < 0)
+                    return JSMN_ERROR_NOMEM;
+#ifdef JSMN_STRICT
+                parser->expect = jsmn_after_string(parser);
+#endif
+                break;
+            case '\t' : case '\r' : case '\n' : case ' ':
+                break;
+            case ':':
+#ifdef JSMN_STRICT
+                if (!counting && !(parser->expect & JSMN_EXPECT_COLON)) {
+                    return JSMN_ERROR_INVAL;
+                }
+                parser->expect = JSMN_EXPECT_VALUE;
+#endif
+                factory->toksuper = factory->toknext - 1;
+                break;
+            case ',':
+                if (counting)
+                    break;
+#ifdef JSMN_STRICT
+                if (!(parser->expect & JSMN_EXPECT_COMMA)) {
+                    return JSMN_ERROR_INVAL;
+                }
+#endif
+                // The next member or element of the innermost container
+                factory->toksuper = jsmn_open_top(factory);
+#ifdef JSMN_STRICT
+                parser->expect =
+                        factory->toks[factory->toksuper].type == JSMN_OBJECT ?
+                        JSMN_EXPECT_KEY : JSMN_EXPECT_VALUE;
+#endif
+                break;
+#ifdef JSMN_STRICT
+            // In strict mode primitives are: numbers and booleans
+            case '-': case '0': case '1' : case '2': case '3' : case '4':
+            case '5': case '6': case '7' : case '8': case '9':
+            case 't': case 'f': case 'n' :
+                if (!counting && !(parser->expect & JSMN_EXPECT_VALUE)) {
+                    return JSMN_ERROR_INVAL;
+                }
+#else
+            // In permissive mode anything else starts a primitive, which may
+            // also be a key
+            default:
+#endif
+                r = jsmn_parse_primitive(parser, ix, js, len, parser->pos);
+                if (r < 0) return r;
+                count++;
+                if (factory->toksuper != -1 && !counting &&
+                        jsmn_add_child(factory) < 0)
+                    return JSMN_ERROR_NOMEM;
+#ifdef JSMN_STRICT
+                parser->expect = jsmn_after_value(parser);
+#endif
+                break;
+
+#ifdef JSMN_STRICT
+            // Unexpected char in strict mode
+            default:
+                return JSMN_ERROR_INVAL;
+#endif
+        }
+    }
+
+    // Unmatched opened object or array
+    if (!counting && factory->depth > 0) {
+        return JSMN_ERROR_PART;
+    }
+
+    return count;
+}
+
+/**
+ * Parses the JSON string from the current position up to 'len'.
+ */
+static int jsmn_parse_chunk(jsmn_Parser *parser, const char *js, size_t len) {
+    jsmn_Index ix;
+    int r;
+
+    // Only count the token boundaries and check primitives in strict mode,
+    // the parse filling the tokens checks strings. The parser counts unless
+    // the data is unusual, invalid or cut off.
+    if (jsmn_is_counting((jsmn_Factory *)parser) &&
+            parser->tokpart == JSMN_UNDEFINED) {
+        r = jsmn_count_tokens(js, parser->pos, len);
+        if (r >= 0) {
+            parser->pos = len;
+            return r;
+        }
+    }
+    jsmn_index_init(&ix, js, len);
+    return jsmn_parse_indexed(parser, &ix, js, len);
+}
+
+int jsmn_parse(jsmn_Parser *parser, const char *js, size_t len) {
+#ifndef JSMN_COMPACT_TOKENS
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    int count = factory->toknext;
+    int i;
+
+    if (parser->js == NULL) {
+        parser->js = js;
+    } else if (parser->js != js) {
+        // JSON string has been realocated, re-calculate old data pointers
+        int offset = js - parser->js;
+        for (i = 0; i < count; i++) {
+            if (factory->toks[i].data != NULL) {
+                factory->toks[i].data += offset;
+            }
+        }
+        parser->js = js;
+    }
+#else
+    // Compact tokens only have offsets, which stay valid
+    parser->js = js;
+#endif
+    return jsmn_parse_chunk(parser, js, len);
+}
+
+int jsmn_stream_parse(jsmn_Parser *parser, const char *js, size_t len) {
+    parser->js = js;
+    return jsmn_parse_chunk(parser, js, len);
+}
+
+/**
+ * Moves the token 'old' still referred to by a stream parse to 'i'.
+ */
+static void jsmn_stream_keep(jsmn_Token *toks, int old, int i) {
+    toks[i] = toks[old];
+#ifdef JSMN_PARENT_LINKS
+    toks[i].parent = i - 1;
+#endif
+#ifndef JSMN_COMPACT_TOKENS
+    // Their data is going to be dropped
+    toks[i].data = NULL;
+#endif
+}
+
+size_t jsmn_stream_release(jsmn_Parser *parser) {
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmn_Token *toks = factory->toks;
+    int c = -1; // open object or array before it moved
+    int link = -1; // the open one after it beyond the stack
+    int moved = -1; // index it moved to
+    int n = 0;
+    int i;
+    unsigned int shift;
+
+    if (toks != NULL) {
+        // Beyond the stack the open objects and arrays are linked from the
+        // innermost outwards, reverse the links to go through them from the
+        // root
+        c = factory->open;
+        for (i = factory->depth; i > JSMN_MAX_DEPTH; i--) {
+            int outer = toks[c].length;
+            toks[c].length = link;
+            link = c;
+            c = outer;
+        }
+        // Move the open objects and arrays and the labels in between to the
+        // front, the parser still refers to them. Each label precedes its
+        // value, the root first. Tokens only move down, so the ones still to
+        // be looked at stay where they are.
+        c = -1;
+        for (i = 0; i < (int)factory->depth; i++) {
+            int outer = c;
+            int super;
+            if (i < JSMN_MAX_DEPTH) {
+                c = factory->stack[i];
+            } else {
+                c = link;
+                link = toks[c].length;
+            }
+            super = jsmn_container_super(factory, c, outer);
+            if (super != -1 && super != outer) {
+                jsmn_stream_keep(toks, super, n++);
+            }
+            jsmn_stream_keep(toks, c, n);
+            if (i < JSMN_MAX_DEPTH) {
+                factory->stack[i] = n;
+            } else {
+                toks[n].length = moved;
+                factory->open = n;
+            }
+            moved = n++;
+        }
+        if (factory->toksuper != -1 && factory->toksuper != c) {
+            jsmn_stream_keep(toks, factory->toksuper, n++);
+            factory->toksuper = n - 1;
+        } else {
+            factory->toksuper = moved;
+            // A key waiting for its colon, which makes it superior, is the
+            // last child added to the object
+            if (moved != -1 && toks[moved].type == JSMN_OBJECT &&
+                    (int)factory->toknext - 1 > c &&
+                    toks[moved].next == (int)factory->toknext) {
+                jsmn_stream_keep(toks, factory->toknext - 1, n++);
+            }
+        }
+        for (i = 0; i < n; i++) {
+            toks[i].next = n;
+        }
+        factory->toknext = n;
+    }
+    // Drop everything before the current position or the cut off token
+    shift = parser->pos;
+    if (parser->tokpart != JSMN_UNDEFINED) {
+        shift = parser->tokstart;
+        parser->tokstart = 0;
+    }
+    parser->pos -= shift;
+    parser->base += shift;
+    return shift;
+}
+
+/**
+ * Resets the parser after a failed record, dropping the tokens from 'first'.
+ */
+static void jsmn_record_rollback(jsmn_Parser *parser, int first)
+{
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    factory->toknext = first;
+    factory->toksuper = -1;
+    factory->depth = 0;
+    parser->expect = JSMN_EXPECT_VALUE;
+    parser->tokpart = JSMN_UNDEFINED;
+}
+
+int jsmn_parse_records(jsmn_Parser *parser, const char *js, size_t len,
+        jsmn_Record *records, size_t recordslen)
+{
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmn_Index ix;
+    const char *nl;
+    unsigned int begin;
+    size_t end;
+    size_t stop;
+    int count = 0;
+    int first;
+    int line;
+    int r;
+    int i;
+
+    if (jsmn_is_counting(factory)) {
+        return JSMN_ERROR_NOMEM;
+    }
+    parser->js = js;
+    // One index for all lines, so short lines share the classified blocks
+    jsmn_index_init(&ix, js, len);
+    while (parser->pos < len) {
+        // Each line is parsed on its own, including its newline which ends
+        // a primitive at the root
+        begin = parser->pos;
+        nl = memchr(js + begin, '\n', len - begin);
+        end = nl != NULL ? (size_t)(nl - js) + 1 : len;
+        first = factory->toknext;
+        line = count;
+        r = jsmn_parse_indexed(parser, &ix, js, end);
+#ifdef JSMN_STRICT
+        // The end of the data ends the last line and a primitive on it
+        if (r == JSMN_ERROR_PART && nl == NULL && factory->depth == 0 &&
+                parser->tokpart == JSMN_PRIMITIVE) {
+            parser->tokpart = JSMN_UNDEFINED;
+            r = jsmn_end_primitive(parser, js, parser->tokstart);
+            parser->expect = JSMN_EXPECT_VALUE;
+        }
+#endif
+        if (r < 0) {
+            // The whole line is one failed record, without tokens
+            jsmn_record_rollback(parser, first);
+            while (begin < end && (js[begin] == ' ' || js[begin] == '\t')) {
+                begin++;
+            }
+            if ((size_t)count == recordslen) {
+                parser->pos = begin;
+                return line > 0 ? line : JSMN_ERROR_NOMEM;
+            }
+            records[count].error = r;
+            records[count].token = first;
+            records[count].count = 0;
+            records[count].start = begin;
+            // Up to the line break, LF or CRLF
+            stop = nl != NULL ? end - 1 : end;
+            if (stop > begin && js[stop - 1] == '\r') {
+                stop--;
+            }
+            records[count].length = stop - begin;
+            count++;
+            parser->pos = end;
+            continue;
+        }
+        // Every value at the root of the line is a record
+        for (i = first; i < (int)factory->toknext; i = factory->toks[i].next) {
+            const jsmn_Token *t = &factory->toks[i];
+            unsigned int start = t->start - parser->base;
+            unsigned int length = t->length;
+            if ((size_t)count == recordslen) {
+                // Leave the whole line to the next call
+                factory->toknext = first;
+                parser->pos = begin;
+                return line > 0 ? line : JSMN_ERROR_NOMEM;
+            }
+            if (t->type == JSMN_STRING || t->type == JSMN_LABEL) {
+                // Including the quotes
+                start--;
+                length += 2;
+            }
+            records[count].error = 0;
+            records[count].token = i;
+            records[count].count = t->next - i;
+            records[count].start = start;
+            records[count].length = length;
+            count++;
+        }
+        parser->pos = end;
+    }
+    return count;
+}
+
+#ifdef JSMN_MMAP
+int jsmn_parse_fd(jsmn_File *file, int fd, const jsmn_Allocator *alloc)
+{
+    struct stat st;
+    void *js;
+
+    jsmn_parser_init_alloc(&file->parser, alloc);
+    file->js = NULL;
+    file->len = 0;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        return JSMN_ERROR_IO;
+    }
+    // Offsets of the parser are 32 bit
+    if ((uintmax_t)st.st_size > UINT_MAX) {
+        return JSMN_ERROR_IO;
+    }
+    if (st.st_size > 0) {
+        js = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (js == MAP_FAILED) {
+            return JSMN_ERROR_IO;
+        }
+        // The parser reads the file once from start to end, the advice is
+        // only declared when the C library exposes POSIX or BSD extensions
+#ifdef POSIX_MADV_SEQUENTIAL
+        posix_madvise(js, st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_HUGEPAGE
+        madvise(js, st.st_size, MADV_HUGEPAGE);
+#endif
+        file->js = js;
+        file->len = st.st_size;
+    }
+    return jsmn_parse(&file->parser, file->js, file->len);
+}
+
+int jsmn_parse_file(jsmn_File *file, const char *path,
+        const jsmn_Allocator *alloc)
+{
+    int fd = open(path, O_RDONLY);
+    int r;
+
+    if (fd < 0) {
+        jsmn_parser_init_alloc(&file->parser, alloc);
+        file->js = NULL;
+        file->len = 0;
+        return JSMN_ERROR_IO;
+    }
+    r = jsmn_parse_fd(file, fd, alloc);
+    close(fd);
+    return r;
+}
+
+void jsmn_file_close(jsmn_File *file)
+{
+    jsmn_factory_free(&file->parser.factory);
+    if (file->js != NULL) {
+        munmap((void *)file->js, file->len);
+    }
+    file->js = NULL;
+    file->len = 0;
+}
+#endif
+
+#ifdef JSMN_THREADS
+/**
+ * Minimal number of bytes of a chunk of a parallel parse.
+ */
+#define JSMN_CHUNK_MIN (64 * 1024)
+
+/**
+ * Number of chunks per thread, which are taken one after the other by the
+ * threads which are free.
+ */
+#define JSMN_CHUNKS_PER_THREAD 16
+
+/**
+ * Number of chunks per thread which may be parsed ahead of the first chunk
+ * not yet handed to the handler.
+ */
+#define JSMN_CHUNKS_AHEAD 4
+
+/**
+ * Results of a chunk of a parallel parse.
+ */
+typedef struct {
+    jsmn_Parser parser; // tokens of the chunk
+    jsmn_Record *records; // records of the chunk
+    size_t recordslen; // length of the records array
+    int count; // number of records or an error
+    int done; // the chunk is parsed and waits for the handler
+} jsmn_Slot;
+
+/**
+ * State shared by the threads of a parallel parse.
+ */
+typedef struct {
+    const char *js;
+    size_t len;
+    size_t chunk; // number of bytes of a chunk
+    const jsmn_Allocator *alloc;
+    jsmn_records_handle_t cb;
+    void *ctx;
+    pthread_mutex_t lock;
+    pthread_cond_t cond; // signalled when a chunk has been handed over
+    jsmn_Slot *slots; // results of the chunks, chunk i in slot i % nslots
+    unsigned int nslots;
+    unsigned int taken; // number of chunks taken by the threads
+    unsigned int handed; // number of chunks handed to the handler
+    size_t next; // offset of the next chunk
+    int handing; // a thread calls the handler
+    int error; // error stopping the parse
+    int total; // number of records handed over
+} jsmn_Parallel;
+
+/**
+ * Parses the records from 'start' up to 'end' into 'slot'.
+ */
+static int jsmn_parse_slot(jsmn_Parallel *par, jsmn_Slot *slot, size_t start,
+        size_t end)
+{
+    jsmn_Parser *parser = &slot->parser;
+    jsmn_Token *toks = parser->factory.toks;
+    size_t tokslen = parser->factory.tokslen;
+    jsmn_Record *records;
+    size_t n;
+    int r;
+
+    // Reuse the tokens of the previous chunk of the slot
+    jsmn_parser_init(parser, toks, tokslen);
+    parser->factory.alloc = par->alloc;
+    parser->pos = start;
+    slot->count = 0;
+    for (;;) {
+        r = jsmn_parse_records(parser, par->js, end,
+                slot->records + slot->count, slot->recordslen - slot->count);
+        if (r > 0) {
+            slot->count += r;
+        }
+        if (parser->pos >= end) {
+            return slot->count;
+        }
+        // The records of the next line do not fit
+        n = slot->recordslen > 0 ? 2 * slot->recordslen : 256;
+        records = realloc(slot->records, n * sizeof(*records));
+        if (records == NULL) {
+            return JSMN_ERROR_NOMEM;
+        }
+        slot->records = records;
+        slot->recordslen = n;
+    }
+}
+
+/**
+ * Hands the parsed chunks to the handler in input order. Only one thread at a
+ * time does so, the lock is held on entry and exit.
+ */
+static void jsmn_hand_over(jsmn_Parallel *par)
+{
+    while (!par->handing && par->error == 0 &&
+            par->handed < par->taken && par->slots[par->handed %
+            par->nslots].done) {
+        jsmn_Slot *slot = &par->slots[par->handed % par->nslots];
+        int r = slot->count;
+        par->handing = 1;
+        pthread_mutex_unlock(&par->lock);
+        if (r >= 0) {
+            r = par->cb(par->ctx, par->js, slot->parser.factory.toks,
+                    slot->records, slot->count);
+        }
+        pthread_mutex_lock(&par->lock);
+        par->handing = 0;
+        if (r < 0) {
+            par->error = r;
+        } else {
+            par->total += slot->count;
+        }
+        slot->done = 0;
+        par->handed++;
+        pthread_cond_broadcast(&par->cond);
+    }
+}
+
+/**
+ * Takes the next chunk, parses it and hands over the parsed chunks, until
+ * there are no chunks left.
+ */
+static void *jsmn_parallel_worker(void *arg)
+{
+    jsmn_Parallel *par = arg;
+    int r;
+
+    pthread_mutex_lock(&par->lock);
+    while (par->error == 0 && par->next < par->len) {
+        jsmn_Slot *slot;
+        const char *nl;
+        size_t start = par->next;
+        size_t end = par->len;
+        // Wait for the slot of the chunk, if the handler lags behind
+        if (par->taken - par->handed >= par->nslots) {
+            pthread_cond_wait(&par->cond, &par->lock);
+            continue;
+        }
+        // The chunk ends with a line
+        if (par->len - start > par->chunk) {
+            nl = memchr(par->js + start + par->chunk, '\n',
+                    par->len - start - par->chunk);
+            if (nl != NULL) {
+                end = nl - par->js + 1;
+            }
+        }
+        slot = &par->slots[par->taken++ % par->nslots];
+        par->next = end;
+        pthread_mutex_unlock(&par->lock);
+        r = jsmn_parse_slot(par, slot, start, end);
+        pthread_mutex_lock(&par->lock);
+        slot->count = r;
+        slot->done = 1;
+        jsmn_hand_over(par);
+    }
+    pthread_mutex_unlock(&par->lock);
+    return NULL;
+}
+
+int jsmn_parse_parallel(const char *js, size_t len, unsigned int threads,
+        const jsmn_Allocator *alloc, jsmn_records_handle_t cb, void *ctx)
+{
+    jsmn_Parallel par;
+    pthread_t *tids;
+    unsigned int started = 0;
+    unsigned int i;
+
+    if (alloc == NULL || len > UINT_MAX) {
+        return JSMN_ERROR_NOMEM;
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    par.js = js;
+    par.len = len;
+    par.chunk = len / (threads * JSMN_CHUNKS_PER_THREAD);
+    if (par.chunk < JSMN_CHUNK_MIN) {
+        par.chunk = JSMN_CHUNK_MIN;
+    }
+    par.alloc = alloc;
+    par.cb = cb;
+    par.ctx = ctx;
+    par.nslots = threads * JSMN_CHUNKS_AHEAD;
+    par.taken = 0;
+    par.handed = 0;
+    par.next = 0;
+    par.handing = 0;
+    par.error = 0;
+    par.total = 0;
+    par.slots = calloc(par.nslots, sizeof(*par.slots));
+    tids = calloc(threads, sizeof(*tids));
+    if (par.slots == NULL || tids == NULL) {
+        free(par.slots);
+        free(tids);
+        return JSMN_ERROR_NOMEM;
+    }
+    for (i = 0; i < par.nslots; i++) {
+        jsmn_parser_init_alloc(&par.slots[i].parser, alloc);
+    }
+    pthread_mutex_init(&par.lock, NULL);
+    pthread_cond_init(&par.cond, NULL);
+    // The calling thread is one of the threads, it goes on with fewer
+    // threads if some cannot be started
+    for (i = 1; i < threads; i++) {
+        if (pthread_create(&tids[started], NULL, jsmn_parallel_worker,
+                &par) == 0) {
+            started++;
+        }
+    }
+    jsmn_parallel_worker(&par);
+    for (i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    // Chunks parsed after an error are not handed over
+    for (i = 0; i < par.nslots; i++) {
+        jsmn_factory_free(&par.slots[i].parser.factory);
+        free(par.slots[i].records);
+    }
+    pthread_cond_destroy(&par.cond);
+    pthread_mutex_destroy(&par.lock);
+    free(par.slots);
+    free(tids);
+    return par.error < 0 ? par.error : par.total;
+}
+
+static jsmn_Token *jsmn_heap_grow(void *ctx, jsmn_Token *toks, size_t len)
+{
+    (void)ctx;
+    return realloc(toks, len * sizeof(*toks));
+}
+
+static void jsmn_heap_free(void *ctx, jsmn_Token *toks)
+{
+    (void)ctx;
+    free(toks);
+}
+
+/**
+ * Allocator of the token arrays of the chunks of a split parse.
+ */
+static const jsmn_Allocator jsmn_heap = { jsmn_heap_grow, jsmn_heap_free,
+        NULL };
+
+/**
+ * Object or array open at the start of a chunk of a split parse.
+ */
+typedef struct {
+    unsigned int start; // offset of its bracket
+    jsmntype_t type;
+    int label; // a colon made a label or another value superior to it
+} jsmn_Open;
+
+/**
+ * Chunk of a split parse.
+ */
+typedef struct {
+    unsigned int start; // offset of the chunk
+    unsigned int end; // offset after the chunk
+    int quotes; // parity of the quotes within the chunk
+    unsigned int pops; // closing brackets of objects and arrays opened before
+    unsigned int npush; // objects and arrays left open by the chunk
+    jsmn_Open push[JSMN_MAX_DEPTH];
+    unsigned int nseed; // objects and arrays open at the start
+    jsmn_Open seed[JSMN_MAX_DEPTH];
+    int invalid; // the chunk cannot be parsed on its own
+    jsmn_Parser parser; // tokens of the chunk
+    int result; // result of the parse of the chunk
+    unsigned int proxies; // number of tokens standing for the seeds
+    int proxymap[2 * JSMN_MAX_DEPTH]; // tokens the proxies stand for
+    unsigned int offset; // index of the first token of the chunk
+} jsmn_Chunk;
+
+/**
+ * State shared by the threads of a split parse.
+ */
+typedef struct {
+    const char *js;
+    jsmn_Chunk *chunks;
+    unsigned int n; // number of chunks
+    jsmn_Token *toks; // the token array the chunks are copied to
+} jsmn_Split;
+
+/**
+ * Function of a thread of a split parse.
+ */
+typedef struct {
+    void (*fn)(jsmn_Split *split, jsmn_Chunk *chunk);
+    jsmn_Split *split;
+    unsigned int k; // index of the chunk
+    int started; // the thread has been started
+    pthread_t tid;
+} jsmn_Task;
+
+static void *jsmn_task_run(void *arg)
+{
+    jsmn_Task *task = arg;
+    task->fn(task->split, &task->split->chunks[task->k]);
+    return NULL;
+}
+
+/**
+ * Runs 'fn' for every chunk, each on its own thread. Chunks whose thread
+ * cannot be started are run by the calling thread.
+ */
+static void jsmn_split_run(jsmn_Split *split, jsmn_Task *tasks,
+        void (*fn)(jsmn_Split *split, jsmn_Chunk *chunk))
+{
+    unsigned int k;
+
+    for (k = 1; k < split->n; k++) {
+        tasks[k].fn = fn;
+        tasks[k].split = split;
+        tasks[k].k = k;
+        tasks[k].started = pthread_create(&tasks[k].tid, NULL,
+                jsmn_task_run, &tasks[k]) == 0;
+    }
+    fn(split, &split->chunks[0]);
+    for (k = 1; k < split->n; k++) {
+        if (tasks[k].started) {
+            pthread_join(tasks[k].tid, NULL);
+        } else {
+            fn(split, &split->chunks[k]);
+        }
+    }
+}
+
+/**
+ * Counts the quotes from 'pos' up to 'end' one by one, skipping escaped ones.
+ * Returns the parity of the count.
+ */
+static int jsmn_split_quote_bytes(const char *js, unsigned int pos,
+        unsigned int end, int *escaped)
+{
+    int quotes = 0;
+    for (; pos < end; pos++) {
+        if (*escaped) {
+            *escaped = 0;
+        } else if (js[pos] == '\\') {
+            *escaped = 1;
+        } else if (js[pos] == '\"') {
+            quotes ^= 1;
+        }
+    }
+    return quotes;
+}
+
+/**
+ * Counts the quotes of the chunk, which may start within a string. Blocks
+ * without backslashes only need the population count of their quotes.
+ */
+static void jsmn_split_quotes(jsmn_Split *split, jsmn_Chunk *chunk)
+{
+    const char *js = split->js;
+    unsigned int pos = chunk->start;
+    int escaped = 0;
+    int quotes = 0;
+
+#ifdef JSMN_SIMD
+    for (; pos + JSMN_INDEX_BLOCK <= chunk->end; pos += JSMN_INDEX_BLOCK) {
+        uint64_t masks[JSMN_SKIP_CLASSES];
+        jsmn_classify_skip(js + pos, masks);
+        if (masks[JSMN_SKIP_SLOW] == 0 && !escaped) {
+            quotes ^= __builtin_popcountll(masks[JSMN_SKIP_QUOTE]) & 1;
+        } else {
+            quotes ^= jsmn_split_quote_bytes(js, pos, pos + JSMN_INDEX_BLOCK,
+                    &escaped);
+        }
+    }
+#endif
+    chunk->quotes = quotes ^ jsmn_split_quote_bytes(js, pos, chunk->end,
+            &escaped);
+}
+
+/**
+ * Returns the position of the first comma outside of strings from 'pos' up
+ * to 'end' or UINT_MAX.
+ */
+static unsigned int jsmn_split_comma(const char *js, unsigned int pos,
+        unsigned int end, int string)
+{
+    int escaped = 0;
+    for (; pos < end; pos++) {
+        char c = js[pos];
+        if (escaped) {
+            escaped = 0;
+        } else if (string) {
+            if (c == '\\') {
+                escaped = 1;
+            } else if (c == '\"') {
+                string = 0;
+            }
+        } else if (c == '\"') {
+            string = 1;
+        } else if (c == ',') {
+            return pos;
+        }
+    }
+    return UINT_MAX;
+}
+
+/**
+ * Counts the bracket at 'pos' of the chunk. An opening one is pushed, a
+ * closing one pops the last pushed one or an object or array opened before.
+ */
+static void jsmn_split_bracket(jsmn_Chunk *chunk, const char *js,
+        unsigned int pos)
+{
+    unsigned int p = pos;
+    if (js[pos] == '}' || js[pos] == ']') {
+        if (chunk->npush > 0) {
+            chunk->npush--;
+        } else {
+            chunk->pops++;
+        }
+        return;
+    }
+    if (chunk->npush == JSMN_MAX_DEPTH) {
+        chunk->invalid = 1;
+        return;
+    }
+    // Whether a colon precedes it, the chunk starts after a comma
+    while (p > chunk->start && (js[p - 1] == ' ' || js[p - 1] == '\t' ||
+            js[p - 1] == '\n' || js[p - 1] == '\r')) {
+        p--;
+    }
+    chunk->push[chunk->npush].start = pos;
+    chunk->push[chunk->npush].type = js[pos] == '{' ? JSMN_OBJECT : JSMN_ARRAY;
+    chunk->push[chunk->npush].label = p > chunk->start && js[p - 1] == ':';
+    chunk->npush++;
+}
+
+/**
+ * Balances the brackets from 'pos' up to 'end' one by one. Returns whether
+ * 'end' is within a string.
+ */
+static int jsmn_split_bracket_bytes(jsmn_Chunk *chunk, const char *js,
+        unsigned int pos, unsigned int end, int string, int *escaped)
+{
+    for (; pos < end; pos++) {
+        char c = js[pos];
+        if (*escaped) {
+            *escaped = 0;
+        } else if (c == '\0') {
+            // Left to the serial parse
+            chunk->invalid = 1;
+        } else if (string) {
+            if (c == '\\') {
+                *escaped = 1;
+            } else if (c == '\"') {
+                string = 0;
+            }
+        } else if (c == '\"') {
+            string = 1;
+        } else if (c == '{' || c == '[' || c == '}' || c == ']') {
+            jsmn_split_bracket(chunk, js, pos);
+        }
+    }
+    return string;
+}
+
+/**
+ * Balances the brackets of the chunk, which starts after a comma outside of
+ * strings. Finds the number of brackets closing objects and arrays opened
+ * before the chunk and the objects and arrays left open by it. Like
+ * 'jsmn_skip_container' strings are found by a prefix XOR over the quotes of
+ * a block, blocks with backslashes are looked at byte by byte.
+ */
+static void jsmn_split_brackets(jsmn_Split *split, jsmn_Chunk *chunk)
+{
+    const char *js = split->js;
+    unsigned int pos = chunk->start;
+    int escaped = 0;
+    int string = 0;
+
+    chunk->pops = 0;
+    chunk->npush = 0;
+#ifdef JSMN_SIMD
+    for (; pos + JSMN_INDEX_BLOCK <= chunk->end; pos += JSMN_INDEX_BLOCK) {
+        uint64_t masks[JSMN_SKIP_CLASSES];
+        uint64_t inside;
+        uint64_t brackets;
+        jsmn_classify_skip(js + pos, masks);
+        if (masks[JSMN_SKIP_SLOW] != 0 || escaped) {
+            string = jsmn_split_bracket_bytes(chunk, js, pos,
+                    pos + JSMN_INDEX_BLOCK, string, &escaped);
+            continue;
+        }
+        inside = masks[JSMN_SKIP_QUOTE];
+        inside ^= inside << 1;
+        inside ^= inside << 2;
+        inside ^= inside << 4;
+        inside ^= inside << 8;
+        inside ^= inside << 16;
+        inside ^= inside << 32;
+        if (string) {
+            inside = ~inside;
+        }
+        brackets = (masks[JSMN_SKIP_OPEN] | masks[JSMN_SKIP_CLOSE]) & ~inside;
+        while (brackets != 0) {
+            jsmn_split_bracket(chunk, js, pos + __builtin_ctzll(brackets));
+            brackets &= brackets - 1;
+        }
+        string = inside >> 63;
+    }
+#endif
+    string = jsmn_split_bracket_bytes(chunk, js, pos, chunk->end, string,
+            &escaped);
+    // The chunk has to end with a comma outside of strings
+    if (string || escaped) {
+        chunk->invalid = 1;
+    }
+}
+
+/**
+ * Parses the chunk on its own. The objects and arrays open at its start, and
+ * the labels of their values, are stood for by proxy tokens in front of the
+ * tokens of the chunk.
+ */
+static void jsmn_split_parse(jsmn_Split *split, jsmn_Chunk *chunk)
+{
+    jsmn_Parser *parser = &chunk->parser;
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmn_Index ix;
+    jsmn_Token *token;
+    unsigned int i;
+
+    jsmn_parser_init_alloc(parser, &jsmn_heap);
+    parser->js = split->js;
+    parser->pos = chunk->start;
+    for (i = 0; i < chunk->nseed; i++) {
+        if (chunk->seed[i].label) {
+            token = jsmn_alloc_token(factory, 1);
+            if (token == NULL) {
+                chunk->result = JSMN_ERROR_NOMEM;
+                return;
+            }
+            token->type = JSMN_LABEL;
+            token->size = 1;
+            token->next = -1;
+#ifdef JSMN_PARENT_LINKS
+            token->parent = factory->toksuper;
+#endif
+        }
+        token = jsmn_alloc_token(factory, 1);
+        if (token == NULL) {
+            chunk->result = JSMN_ERROR_NOMEM;
+            return;
+        }
+        jsmn_fill_token(token, chunk->seed[i].type, split->js, 0,
+                chunk->seed[i].start, chunk->seed[i].start);
+        // Not closed yet, nor have members or elements been added
+        token->length = -1;
+        token->next = -1;
+#ifdef JSMN_PARENT_LINKS
+        token->parent = chunk->seed[i].label ? (int)factory->toknext - 2 :
+                factory->toksuper;
+#endif
+        factory->toksuper = factory->toknext - 1;
+        jsmn_open_push(factory, factory->toksuper);
+    }
+    chunk->proxies = factory->toknext;
+#ifdef JSMN_STRICT
+    // Like after the comma preceding the chunk
+    if (chunk->nseed > 0) {
+        parser->expect = chunk->seed[chunk->nseed - 1].type == JSMN_OBJECT ?
+                JSMN_EXPECT_KEY : JSMN_EXPECT_VALUE;
+    }
+#endif
+    jsmn_index_init(&ix, split->js, chunk->end);
+    chunk->result = jsmn_parse_indexed(parser, &ix, split->js, chunk->end);
+}
+
+/**
+ * Checks that the parse of the chunk ends right after a comma with the
+ * objects and arrays open, which the next chunk has been parsed with.
+ */
+static int jsmn_split_check(const jsmn_Chunk *chunk, const jsmn_Chunk *next)
+{
+    const jsmn_Parser *parser = &chunk->parser;
+    const jsmn_Factory *factory = &parser->factory;
+    unsigned int i;
+
+    if (chunk->result != JSMN_ERROR_PART ||
+            parser->tokpart != JSMN_UNDEFINED ||
+            parser->pos != chunk->end || factory->depth != next->nseed ||
+            factory->toksuper != jsmn_open_top(factory)) {
+        return 0;
+    }
+    // The seeds of a chunk fit onto the stack
+    for (i = 0; i < factory->depth; i++) {
+        int outer = i > 0 ? factory->stack[i - 1] : -1;
+        const jsmn_Token *t = &factory->toks[factory->stack[i]];
+        int super = jsmn_container_super(factory, factory->stack[i], outer);
+        if (t->type != next->seed[i].type ||
+                t->start != next->seed[i].start ||
+                (super != outer) != next->seed[i].label) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Returns the index in the whole token array of the token 'i' of the chunk.
+ */
+static inline int jsmn_split_map(const jsmn_Chunk *chunk, int i)
+{
+    if (i < 0) {
+        return i;
+    }
+    return (unsigned int)i < chunk->proxies ? chunk->proxymap[i] :
+            (int)(chunk->offset + i - chunk->proxies);
+}
+
+/**
+ * Copies the tokens of the chunk, but the proxies, to the whole token array.
+ */
+static void jsmn_split_copy(jsmn_Split *split, jsmn_Chunk *chunk)
+{
+    const jsmn_Factory *factory = &chunk->parser.factory;
+    jsmn_Token *out = split->toks + chunk->offset;
+    unsigned int i;
+
+    for (i = chunk->proxies; i < factory->toknext; i++) {
+        *out = factory->toks[i];
+        out->next = jsmn_split_map(chunk, out->next);
+#ifdef JSMN_PARENT_LINKS
+        out->parent = jsmn_split_map(chunk, out->parent);
+#endif
+        out++;
+    }
+}
+
+/**
+ * Applies what the chunk added to the objects and arrays opened before it,
+ * and to their labels.
+ */
+static int jsmn_split_apply(jsmn_Split *split, jsmn_Chunk *chunk)
+{
+    const jsmn_Token *toks = chunk->parser.factory.toks;
+    unsigned int i;
+
+    for (i = 0; i < chunk->proxies; i++) {
+        jsmn_Token *t = &split->toks[chunk->proxymap[i]];
+        // Labels have their value already
+        size_t size = t->size + toks[i].size -
+                (toks[i].type == JSMN_LABEL ? 1 : 0);
+#ifdef JSMN_COMPACT_TOKENS
+        if (size > JSMN_COMPACT_SIZE_MAX) {
+            return -1;
+        }
+#endif
+        t->size = size;
+        if (toks[i].next != -1) {
+            t->next = jsmn_split_map(chunk, toks[i].next);
+        }
+        if (toks[i].length != -1) {
+            t->length = toks[i].length;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Splits the data into 'n' chunks which end with a comma outside of strings,
+ * and finds the objects and arrays open at the start of every chunk. Returns
+ * the number of chunks, 0 if the data cannot be split like this.
+ */
+static unsigned int jsmn_split_chunks(jsmn_Split *split, jsmn_Task *tasks,
+        size_t len)
+{
+    jsmn_Chunk *chunks = split->chunks;
+    unsigned int n = split->n;
+    unsigned int k;
+    unsigned int m;
+    int quotes = 0;
+
+    // A quote after a backslash at the start of a chunk would be taken for
+    // a closing one
+    for (k = 0; k < n; k++) {
+        chunks[k].start = k * (len / n);
+        if (k > 0 && chunks[k].start < chunks[k - 1].start) {
+            chunks[k].start = chunks[k - 1].start;
+        }
+        while (k > 0 && chunks[k].start < len &&
+                split->js[chunks[k].start - 1] == '\\') {
+            chunks[k].start++;
+        }
+        chunks[k].invalid = 0;
+    }
+    for (k = 0; k < n; k++) {
+        chunks[k].end = k + 1 < n ? chunks[k + 1].start : len;
+    }
+    jsmn_split_run(split, tasks, jsmn_split_quotes);
+    // Guessing from the quotes before each chunk whether it starts within a
+    // string, the chunks are moved to start after their first comma outside
+    // of strings. Chunks without one are merged with the previous one.
+    m = 1;
+    for (k = 1; k < n; k++) {
+        unsigned int comma;
+        quotes ^= chunks[k - 1].quotes;
+        comma = jsmn_split_comma(split->js, chunks[k].start, chunks[k].end,
+                quotes);
+        if (comma != UINT_MAX) {
+            chunks[m].start = comma + 1;
+            chunks[m - 1].end = comma + 1;
+            m++;
+        }
+    }
+    chunks[m - 1].end = len;
+    split->n = m;
+    if (m < 2) {
+        return 0;
+    }
+    jsmn_split_run(split, tasks, jsmn_split_brackets);
+    chunks[0].nseed = 0;
+    for (k = 0; k + 1 < m; k++) {
+        jsmn_Chunk *next = &chunks[k + 1];
+        if (chunks[k].invalid || chunks[k].pops > chunks[k].nseed ||
+                chunks[k].nseed - chunks[k].pops + chunks[k].npush >
+                JSMN_MAX_DEPTH) {
+            return 0;
+        }
+        next->nseed = chunks[k].nseed - chunks[k].pops;
+        memcpy(next->seed, chunks[k].seed, next->nseed * sizeof(jsmn_Open));
+        memcpy(next->seed + next->nseed, chunks[k].push,
+                chunks[k].npush * sizeof(jsmn_Open));
+        next->nseed += chunks[k].npush;
+        // A comma at the root is left to the serial parse
+        if (next->nseed == 0) {
+            return 0;
+        }
+    }
+    return m;
+}
+
+/**
+ * Parses the chunks and joins their tokens into the token array of the
+ * parser. Returns the number of tokens or -1 if the result would not be the
+ * one of the serial parse.
+ */
+static int jsmn_split_parse_all(jsmn_Parser *parser, jsmn_Split *split,
+        jsmn_Task *tasks)
+{
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmn_Chunk *chunks = split->chunks;
+    jsmn_Chunk *last = &chunks[split->n - 1];
+    unsigned int offset = 0;
+    unsigned int i;
+    unsigned int k;
+
+    for (k = 0; k < split->n; k++) {
+        chunks[k].result = JSMN_ERROR_NOMEM;
+    }
+    jsmn_split_run(split, tasks, jsmn_split_parse);
+    // Each chunk has to end the way the next one started, and the objects
+    // and arrays open at its start are mapped to their tokens
+    for (k = 0; k < split->n; k++) {
+        jsmn_Chunk *chunk = &chunks[k];
+        if (k > 0) {
+            const jsmn_Chunk *prev = &chunks[k - 1];
+            unsigned int p = 0;
+            if (!jsmn_split_check(prev, chunk)) {
+                return -1;
+            }
+            for (i = 0; i < chunk->nseed; i++) {
+                int t = jsmn_split_map(prev, prev->parser.factory.stack[i]);
+                if (chunk->seed[i].label) {
+                    chunk->proxymap[p++] = t - 1;
+                }
+                chunk->proxymap[p++] = t;
+            }
+        }
+        chunk->offset = offset;
+        offset += chunk->parser.factory.toknext - chunk->proxies;
+    }
+    if (last->result < 0 || last->parser.factory.depth != 0) {
+        return -1;
+    }
+    if (offset > factory->tokslen && jsmn_grow_tokens(factory, offset) < 0) {
+        return -1;
+    }
+    split->toks = factory->toks;
+    jsmn_split_run(split, tasks, jsmn_split_copy);
+    for (k = 1; k < split->n; k++) {
+        if (jsmn_split_apply(split, &chunks[k]) < 0) {
+            return -1;
+        }
+    }
+    // The parser continues like after the serial parse
+    factory->toknext = offset;
+    factory->toksuper = jsmn_split_map(last, last->parser.factory.toksuper);
+    factory->depth = 0;
+    parser->js = split->js;
+    parser->pos = last->parser.pos;
+    parser->expect = last->parser.expect;
+    parser->tokpart = last->parser.tokpart;
+    parser->tokstart = last->parser.tokstart;
+    parser->tokflags = last->parser.tokflags;
+    return offset;
+}
+
+int jsmn_parse_split(jsmn_Parser *parser, const char *js, size_t len,
+        unsigned int threads)
+{
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmn_Split split;
+    jsmn_Task *tasks;
+    unsigned int k;
+    int r = -1;
+
+    // Only a fresh parse of large enough data with tokens is split
+    while (threads > 1 && len / threads < JSMN_CHUNK_MIN) {
+        threads--;
+    }
+    if (threads < 2 || len > INT_MAX || jsmn_is_counting(factory) ||
+            factory->toknext != 0 || parser->pos != 0 || parser->base != 0) {
+        return jsmn_parse(parser, js, len);
+    }
+    split.js = js;
+    split.n = threads;
+    split.chunks = calloc(threads, sizeof(*split.chunks));
+    tasks = calloc(threads, sizeof(*tasks));
+    if (split.chunks == NULL || tasks == NULL) {
+        free(split.chunks);
+        free(tasks);
+        return jsmn_parse(parser, js, len);
+    }
+    if (jsmn_split_chunks(&split, tasks, len) > 0) {
+        r = jsmn_split_parse_all(parser, &split, tasks);
+        for (k = 0; k < split.n; k++) {
+            jsmn_factory_free(&split.chunks[k].parser.factory);
+        }
+    }
+    free(split.chunks);
+    free(tasks);
+    if (r < 0) {
+        // Whatever the chunks went wrong with, the serial parse finds
+        return jsmn_parse(parser, js, len);
+    }
+    return r;
+}
+#endif
+
+void jsmn_lookup_init(jsmn_Lookup *lookup, int *slots, size_t len) {
+    lookup->slots = slots;
+    lookup->slotslen = len;
+    lookup->slotsnext = 0;
+    lookup->count = 0;
+}
+
+/**
+ * FNV-1a hash of a key.
+ */
+static unsigned int jsmn_hash(const char *key, size_t len) {
+    unsigned int h = 2166136261u;
+    size_t i;
+    for (i = 0; i < len; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int jsmn_label_equal(const char *js, const jsmn_Token *label,
+        const char *key, size_t len)
+{
+    return label->length == (int)len &&
+            memcmp(jsmn_token_data(js, label), key, len) == 0;
+}
+
+/**
+ * Returns the index of the hash table of the object, builds it on first use.
+ * Returns -1, if the object cannot be indexed.
+ */
+static int jsmn_lookup_table(jsmn_Lookup *lookup, const char *js,
+        const jsmn_Token *toks, int object)
+{
+    unsigned int i;
+    unsigned int n;
+    unsigned int h;
+    int *slots;
+    int label;
+
+    for (i = 0; i < lookup->count; i++) {
+        if (lookup->tables[i].object == object) {
+            return i;
+        }
+    }
+    if (lookup->count == JSMN_LOOKUP_OBJECTS) {
+        return -1;
+    }
+    // The table is filled to at most a half
+    for (n = 16; n < 2 * (unsigned int)toks[object].size; n *= 2);
+    if (n > lookup->slotslen - lookup->slotsnext) {
+        return -1;
+    }
+    slots = lookup->slots + lookup->slotsnext;
+    memset(slots, 0, n * sizeof(int));
+    // Insert the labels in order, so the first of equal keys is found first
+    for (label = object + 1; label < toks[object].next;
+            label = toks[label].next) {
+        h = jsmn_hash(jsmn_token_data(js, &toks[label]), toks[label].length);
+        for (h &= n - 1; slots[h] != 0; h = (h + 1) & (n - 1));
+        slots[h] = label;
+    }
+    i = lookup->count++;
+    lookup->tables[i].object = object;
+    lookup->tables[i].offset = lookup->slotsnext;
+    lookup->tables[i].mask = n - 1;
+    lookup->slotsnext += n;
+    return i;
+}
+
+int jsmn_lookup(jsmn_Lookup *lookup, const char *js, const jsmn_Token *toks,
+        int object, const char *key, size_t len)
+{
+    int label;
+    int t;
+
+    if (toks[object].type != JSMN_OBJECT) {
+        return JSMN_ERROR_INVAL;
+    }
+    if (lookup != NULL && toks[object].size >= JSMN_LOOKUP_MIN &&
+            (t = jsmn_lookup_table(lookup, js, toks, object)) >= 0) {
+        const int *slots = lookup->slots + lookup->tables[t].offset;
+        unsigned int mask = lookup->tables[t].mask;
+        unsigned int h = jsmn_hash(key, len) & mask;
+        for (; (label = slots[h]) != 0; h = (h + 1) & mask) {
+            if (jsmn_label_equal(js, &toks[label], key, len)) {
+                return label + 1;
+            }
+        }
+        return 0;
+    }
+    // Small or not indexed object
+    for (label = object + 1; label < toks[object].next;
+            label = toks[label].next) {
+        if (jsmn_label_equal(js, &toks[label], key, len)) {
+            return label + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Parses the path segment 'key' of 'len' bytes.
+ */
+static int jsmn_compile_segment(jsmn_Segment *seg, const char *key, int len) {
+    int i;
+    seg->key = key;
+    seg->length = len;
+    seg->index = -1;
+    seg->escaped = 0;
+    if (len == 1 && key[0] == '*') {
+        seg->key = NULL;
+        return 0;
+    }
+    for (i = 0; i < len; i++) {
+        if (key[i] == '~') {
+            // Only '~0' and '~1' are valid escapes
+            if (i + 1 == len || (key[i + 1] != '0' && key[i + 1] != '1')) {
+                return JSMN_ERROR_INVAL;
+            }
+            seg->escaped = 1;
+        }
+    }
+    // An array index has no leading zeros
+    if (len > 0 && len < 10 && (key[0] != '0' || len == 1)) {
+        int index = 0;
+        for (i = 0; i < len && key[i] >= '0' && key[i] <= '9'; i++) {
+            index = index * 10 + (key[i] - '0');
+        }
+        if (i == len) {
+            seg->index = index;
+        }
+    }
+    return 0;
+}
+
+int jsmn_matcher_compile(jsmn_Matcher *matcher, const char **paths,
+        size_t count)
+{
+    size_t i;
+    matcher->count = 0;
+    matcher->segsnext = 0;
+    if (count > JSMN_MATCH_PATHS) {
+        return JSMN_ERROR_INVAL;
+    }
+    for (i = 0; i < count; i++) {
+        const char *p = paths[i];
+        matcher->paths[i].first = matcher->segsnext;
+        matcher->paths[i].length = 0;
+        if (*p != '\0' && *p != '/') {
+            return JSMN_ERROR_INVAL;
+        }
+        while (*p == '/') {
+            const char *key = ++p;
+            while (*p != '\0' && *p != '/') {
+                p++;
+            }
+            if (matcher->segsnext == JSMN_MATCH_SEGMENTS ||
+                    matcher->paths[i].length == JSMN_MAX_DEPTH) {
+                return JSMN_ERROR_INVAL;
+            }
+            if (jsmn_compile_segment(&matcher->segs[matcher->segsnext++], key,
+                    p - key) < 0) {
+                return JSMN_ERROR_INVAL;
+            }
+            matcher->paths[i].length++;
+        }
+        matcher->count++;
+    }
+    return 0;
+}
+
+/**
+ * Compares a member name of a path with the raw data of a label.
+ */
+static int jsmn_segment_equal(const jsmn_Segment *seg, const char *data,
+        int len)
+{
+    int i;
+    int j = 0;
+    if (!seg->escaped) {
+        return seg->length == len && memcmp(seg->key, data, len) == 0;
+    }
+    for (i = 0; i < seg->length; i++, j++) {
+        char c = seg->key[i];
+        if (c == '~') {
+            c = seg->key[++i] == '0' ? '~' : '/';
+        }
+        if (j == len || data[j] != c) {
+            return 0;
+        }
+    }
+    return j == len;
+}
+
+/**
+ * Returns the paths of 'mask' which are longer than 'depth'.
+ */
+static unsigned int jsmn_match_deeper(const jsmn_Matcher *matcher,
+        unsigned int mask, int depth)
+{
+    unsigned int deeper = 0;
+    unsigned int p;
+    for (p = 0; p < matcher->count; p++) {
+        if ((mask & (1u << p)) &&
+                matcher->paths[p].length > (unsigned int)depth) {
+            deeper |= 1u << p;
+        }
+    }
+    return deeper;
+}
+
+/**
+ * Returns the paths of 'mask' whose segment at 'depth' matches the member
+ * name 'key' of 'len' bytes or, if 'key' is NULL, the element 'index'.
+ */
+static unsigned int jsmn_match_child(const jsmn_Matcher *matcher,
+        unsigned int mask, int depth, const char *key, int len, int index)
+{
+    unsigned int child = 0;
+    unsigned int p;
+    for (p = 0; p < matcher->count; p++) {
+        const jsmn_Segment *seg;
+        if (!(mask & (1u << p))) {
+            continue;
+        }
+        seg = &matcher->segs[matcher->paths[p].first + depth];
+        if (seg->key == NULL || (key == NULL ? seg->index == index :
+                jsmn_segment_equal(seg, key, len))) {
+            child |= 1u << p;
+        }
+    }
+    return child;
+}
+
+int jsmn_match(const jsmn_Matcher *matcher, const char *js,
+        const jsmn_Token *toks, int root, jsmn_Match *matches, size_t len)
+{
+    struct {
+        int token; // object or array
+        int child; // next member or element
+        int index; // index of the next element
+        unsigned int mask; // paths leading into the object or array
+    } stack[JSMN_MAX_DEPTH];
+    int depth = 0;
+    int count = 0;
+    int value = root;
+    unsigned int mask = matcher->count == JSMN_MATCH_PATHS ? ~0u :
+            (1u << matcher->count) - 1;
+    unsigned int p;
+
+    for (;;) {
+        // 'value' is at 'depth' and the paths of 'mask' lead to it
+        unsigned int deeper = jsmn_match_deeper(matcher, mask, depth);
+        for (p = 0; p < matcher->count; p++) {
+            if (!(mask & ~deeper & (1u << p))) {
+                continue;
+            }
+            if ((size_t)count == len) {
+                return JSMN_ERROR_NOMEM;
+            }
+            matches[count].path = p;
+            matches[count].token = value;
+            count++;
+        }
+        if (deeper != 0 && toks[value].size > 0 &&
+                (toks[value].type == JSMN_OBJECT ||
+                 toks[value].type == JSMN_ARRAY)) {
+            stack[depth].token = value;
+            stack[depth].child = value + 1;
+            stack[depth].index = 0;
+            stack[depth].mask = deeper;
+            depth++;
+        }
+        // Find the next member or element any path leads to
+        mask = 0;
+        while (mask == 0 && depth > 0) {
+            int c = stack[depth - 1].child;
+            const jsmn_Token *t = &toks[stack[depth - 1].token];
+            if (c >= t->next) {
+                depth--;
+                continue;
+            }
+            if (t->type == JSMN_OBJECT) {
+                mask = jsmn_match_child(matcher, stack[depth - 1].mask,
+                        depth - 1, jsmn_token_data(js, &toks[c]),
+                        toks[c].length, -1);
+                // The value of a member follows its label
+                value = c + 1;
+            } else {
+                mask = jsmn_match_child(matcher, stack[depth - 1].mask,
+                        depth - 1, NULL, 0, stack[depth - 1].index);
+                value = c;
+            }
+            stack[depth - 1].child = toks[c].next;
+            stack[depth - 1].index++;
+        }
+        if (mask == 0) {
+            return count;
+        }
+    }
+}
+
+/**
+ * Skips whitespace.
+ */
+static unsigned int jsmn_skip_space(jsmn_Index *ix, const char *js,
+        size_t len, unsigned int pos)
+{
+    // Most values follow right after a comma or colon
+    if (pos < len && (unsigned char)js[pos] > ' ') {
+        return pos;
+    }
+    pos = jsmn_index_next(ix, pos, JSMN_INDEX_VALUE);
+    while (pos < len && (js[pos] == ' ' || js[pos] == '\t' ||
+            js[pos] == '\n' || js[pos] == '\r')) {
+        pos++;
+    }
+    return pos;
+}
+
+/**
+ * Skips the string starting with the quote at 'pos', returns the position
+ * after its closing quote.
+ */
+static int jsmn_skip_string(const char *js, size_t len, size_t pos) {
+    pos++;
+    for (;;) {
+        pos = jsmn_scan_string(js, pos, len);
+        if (pos >= len || js[pos] == '\0') {
+            return JSMN_ERROR_PART;
+        }
+        if (js[pos] == '\"') {
+            return pos + 1;
+        }
+        // Backslash: skip the escaped character
+        pos += 2;
+    }
+}
+
+/**
+ * Skips the value starting at 'pos' by balancing brackets and strings only,
+ * returns the position after it.
+ */
+static int jsmn_skip_value(const char *js, size_t len, size_t pos) {
+    if (js[pos] == '{' || js[pos] == '[') {
+        return jsmn_skip_container(js, len, pos);
+    }
+    if (js[pos] == '\"') {
+        return jsmn_skip_string(js, len, pos);
+    }
+    // Primitive
+    for (; pos < len; pos++) {
+        switch (js[pos]) {
+            case '\t' : case '\r' : case '\n' : case ' ' :
+            case ','  : case ']'  : case '}'  : case '\0':
+                return pos;
+        }
+    }
+    return pos;
+}
+/**
+ * Checks whether the value starting with 'c' at 'depth' gets tokens, i.e. a
+ * path of 'mask' ends at it or leads into it.
+ */
+static int jsmn_projected(const jsmn_Matcher *matcher, unsigned int mask,
+        int depth, char c)
+{
+    unsigned int deeper = jsmn_match_deeper(matcher, mask, depth);
+    return (mask & ~deeper) != 0 || (deeper != 0 && (c == '{' || c == '['));
+}
+
+int jsmn_parse_projection(jsmn_Parser *parser, const jsmn_Matcher *matcher,
+        const char *js, size_t len, jsmn_Match *matches, size_t matcheslen)
+{
+    jsmn_Factory *factory = (jsmn_Factory *)parser;
+    jsmn_Index ix;
+    jsmn_Token *token;
+    struct jsmn_Frame {
+        unsigned int mask; // paths leading into the object or array
+        int index; // index of the next element
+        int full; // the whole object or array is wanted
+    } frames[JSMN_MAX_DEPTH], *frame;
+    // Deeper than any path only values wanted as a whole get tokens
+    struct jsmn_Frame whole = { 0, 0, 1 };
+    unsigned int mask = matcher->count == JSMN_MATCH_PATHS ? ~0u :
+            (1u << matcher->count) - 1;
+    int full = 0;
+    int count = 0;
+    int keyend;
+    int r;
+    char c;
+    unsigned int p;
+
+    if (jsmn_is_counting(factory)) {
+        return JSMN_ERROR_NOMEM;
+    }
+    parser->js = js;
+    jsmn_index_init(&ix, js, len);
+    parser->pos = jsmn_skip_space(&ix, js, len, parser->pos);
+    if (parser->pos >= len || js[parser->pos] == '\0') {
+        return 0;
+    }
+    if (!jsmn_projected(matcher, mask, 0, js[parser->pos])) {
+        r = jsmn_skip_value(js, len, parser->pos);
+        if (r < 0) return r;
+        parser->pos = r;
+        return 0;
+    }
+
+value:
+    // A wanted value, which the paths of 'mask' lead to, starts at 'pos'
+    c = js[parser->pos];
+    if (mask != 0) {
+        unsigned int deeper = jsmn_match_deeper(matcher, mask, factory->depth);
+        for (p = 0; p < matcher->count; p++) {
+            if (!(mask & ~deeper & (1u << p))) {
+                continue;
+            }
+            if ((size_t)count == matcheslen) {
+                return JSMN_ERROR_NOMEM;
+            }
+            matches[count].path = p;
+            matches[count].token = factory->toknext;
+            count++;
+        }
+        // The value is matched as a whole
+        if ((mask & ~deeper) != 0) {
+            full = 1;
+        }
+        mask = deeper;
+    }
+    if (c == '{' || c == '[') {
+        token = jsmn_alloc_token(factory, 1);
+        if (token == NULL)
+            return JSMN_ERROR_NOMEM;
+        if (factory->toksuper != -1) {
+            if (jsmn_add_child(factory) < 0)
+                return JSMN_ERROR_NOMEM;
+#ifdef JSMN_PARENT_LINKS
+            token->parent = factory->toksuper;
+#endif
+        }
+        token->type = (c == '{' ? JSMN_OBJECT : JSMN_ARRAY);
+#ifndef JSMN_COMPACT_TOKENS
+        token->data = js + parser->pos;
+#endif
+        token->start = parser->base + parser->pos;
+        factory->toksuper = factory->toknext - 1;
+        if (factory->depth < JSMN_MAX_DEPTH) {
+            frames[factory->depth].mask = mask;
+            frames[factory->depth].index = 0;
+            frames[factory->depth].full = full;
+        }
+        jsmn_open_push(factory, factory->toksuper);
+        parser->pos = jsmn_skip_space(&ix, js, len, parser->pos + 1);
+        if (parser->pos >= len || js[parser->pos] == '\0') {
+            return JSMN_ERROR_PART;
+        }
+        if (js[parser->pos] == (c == '{' ? '}' : ']')) {
+            goto close;
+        }
+        goto member;
+    }
+    if (c == '\"') {
+        r = jsmn_parse_string(parser, &ix, js, len, parser->pos);
+    } else if (c == '-' || (c >= '0' && c <= '9') ||
+            c == 't' || c == 'f' || c == 'n') {
+        r = jsmn_parse_primitive(parser, &ix, js, len, parser->pos);
+    } else {
+        return JSMN_ERROR_INVAL;
+    }
+    if (r < 0) return r;
+    if (factory->toksuper != -1 && jsmn_add_child(factory) < 0)
+        return JSMN_ERROR_NOMEM;
+    parser->pos++;
+
+next:
+    // After a value: the next member or element or the end of the container
+    if (factory->depth == 0) {
+        return count;
+    }
+    factory->toksuper = jsmn_open_top(factory);
+    parser->pos = jsmn_skip_space(&ix, js, len, parser->pos);
+    if (parser->pos >= len || js[parser->pos] == '\0') {
+        return JSMN_ERROR_PART;
+    }
+    c = js[parser->pos];
+    if (c == ',') {
+        parser->pos = jsmn_skip_space(&ix, js, len, parser->pos + 1);
+        if (parser->pos >= len || js[parser->pos] == '\0') {
+            return JSMN_ERROR_PART;
+        }
+        goto member;
+    }
+    if (c != (factory->toks[factory->toksuper].type == JSMN_OBJECT ?
+            '}' : ']')) {
+        return JSMN_ERROR_INVAL;
+    }
+
+close:
+    token = &factory->toks[jsmn_open_top(factory)];
+    factory->toksuper = jsmn_container_super(factory, token - factory->toks,
+            jsmn_open_pop(factory));
+    token->length = parser->base + parser->pos - token->start + 1;
+    token->next = factory->toknext;
+    // The subtree of the label or array ends here as well
+    if (factory->toksuper != -1) {
+        factory->toks[factory->toksuper].next = factory->toknext;
+    }
+    parser->pos++;
+    goto next;
+
+member:
+    // A member or element of the innermost container starts at 'pos'
+    frame = factory->depth <= JSMN_MAX_DEPTH ?
+            &frames[factory->depth - 1] : &whole;
+    full = frame->full;
+    if (factory->toks[factory->toksuper].type == JSMN_ARRAY) {
+        int index = frame->index++;
+        mask = jsmn_match_child(matcher, frame->mask, factory->depth - 1,
+                NULL, 0, index);
+        if (!full) {
+            if (!jsmn_projected(matcher, mask, factory->depth,
+                    js[parser->pos])) {
+                r = jsmn_skip_value(js, len, parser->pos);
+                if (r < 0) return r;
+                parser->pos = r;
+                goto next;
+            }
+        }
+        goto value;
+    }
+    if (js[parser->pos] != '\"') {
+        return JSMN_ERROR_INVAL;
+    }
+    keyend = jsmn_skip_string(js, len, parser->pos);
+    if (keyend < 0) return keyend;
+    keyend = jsmn_skip_space(&ix, js, len, keyend);
+    if ((size_t)keyend >= len || js[keyend] == '\0') {
+        return JSMN_ERROR_PART;
+    }
+    if (js[keyend] != ':') {
+        return JSMN_ERROR_INVAL;
+    }
+    mask = 0;
+    if (frame->mask != 0) {
+        // Look at the name before any token is created for the member
+        int end = keyend;
+        while (js[end] != '\"') {
+            end--;
+        }
+        mask = jsmn_match_child(matcher, frame->mask,
+                factory->depth - 1, js + parser->pos + 1,
+                end - parser->pos - 1, -1);
+    }
+    if (!full) {
+        keyend = jsmn_skip_space(&ix, js, len, keyend + 1);
+        if ((size_t)keyend >= len || js[keyend] == '\0') {
+            return JSMN_ERROR_PART;
+        }
+        if (!jsmn_projected(matcher, mask, factory->depth, js[keyend])) {
+            r = jsmn_skip_value(js, len, keyend);
+            if (r < 0) return r;
+            parser->pos = r;
+            goto next;
+        }
+    }
+    // The label
+    r = jsmn_parse_string(parser, &ix, js, len, parser->pos);
+    if (r < 0) return r;
+    if (jsmn_add_child(factory) < 0)
+        return JSMN_ERROR_NOMEM;
+    factory->toksuper = factory->toknext - 1;
+    parser->pos = jsmn_skip_space(&ix, js, len, parser->pos + 1);
+    parser->pos = jsmn_skip_space(&ix, js, len, parser->pos + 1);
+    if (parser->pos >= len || js[parser->pos] == '\0') {
+        return JSMN_ERROR_PART;
+    }
+    goto value;
+}
+
+/**
+ * Powers of ten from 1e-342 to 1e308 as 128 bit mantissas, normalised so that
+ * the most significant bit is set and truncated. Each entry is { high, low }.
+ */
+#define JSMN_POW10_MIN (-342)
+#define JSMN_POW10_MAX 308
+static const uint64_t jsmn_pow10[][2] = {
+    { 0xeef453d6923bd65a, 0x113faa2906a13b3f },
+    { 0x9558b4661b6565f8, 0x4ac7ca59a424c507 },
+    { 0xbaaee17fa23ebf76, 0x5d79bcf00d2df649 },
+    { 0xe95a99df8ace6f53, 0xf4d82c2c107973dc },
+    { 0x91d8a02bb6c10594, 0x79071b9b8a4be869 },
+    { 0xb64ec836a47146f9, 0x9748e2826cdee284 },
+    { 0xe3e27a444d8d98b7, 0xfd1b1b2308169b25 },
+    { 0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7 },
+    { 0xb208ef855c969f4f, 0xbdbd2d335e51a935 },
+    { 0xde8b2b66b3bc4723, 0xad2c788035e61382 },
+    { 0x8b16fb203055ac76, 0x4c3bcb5021afcc31 },
+    { 0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d },
+    { 0xd953e8624b85dd78, 0xd71d6dad34a2af0d },
+    { 0x87d4713d6f33aa6b, 0x8672648c40e5ad68 },
+    { 0xa9c98d8ccb009506, 0x680efdaf511f18c2 },
+    { 0xd43bf0effdc0ba48, 0x0212bd1b2566def2 },
+    { 0x84a57695fe98746d, 0x014bb630f7604b57 },
+    { 0xa5ced43b7e3e9188, 0x419ea3bd35385e2d },
+    { 0xcf42894a5dce35ea, 0x52064cac828675b9 },
+    { 0x818995ce7aa0e1b2, 0x7343efebd1940993 },
+    { 0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8 },
+    { 0xca66fa129f9b60a6, 0xd41a26e077774ef6 },
+    { 0xfd00b897478238d0, 0x8920b098955522b4 },
+    { 0x9e20735e8cb16382, 0x55b46e5f5d5535b0 },
+    { 0xc5a890362fddbc62, 0xeb2189f734aa831d },
+    { 0xf712b443bbd52b7b, 0xa5e9ec7501d523e4 },
+    { 0x9a6bb0aa55653b2d, 0x47b233c92125366e },
+    { 0xc1069cd4eabe89f8, 0x999ec0bb696e840a },
+    { 0xf148440a256e2c76, 0xc00670ea43ca250d },
+    { 0x96cd2a865764dbca, 0x380406926a5e5728 },
+    { 0xbc807527ed3e12bc, 0xc605083704f5ecf2 },
+    { 0xeba09271e88d976b, 0xf7864a44c633682e },
+    { 0x93445b8731587ea3, 0x7ab3ee6afbe0211d },
+    { 0xb8157268fdae9e4c, 0x5960ea05bad82964 },
+    { 0xe61acf033d1a45df, 0x6fb92487298e33bd },
+    { 0x8fd0c16206306bab, 0xa5d3b6d479f8e056 },
+    { 0xb3c4f1ba87bc8696, 0x8f48a4899877186c },
+    { 0xe0b62e2929aba83c, 0x331acdabfe94de87 },
+    { 0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14 },
+    { 0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9 },
+    { 0xdb71e91432b1a24a, 0xc9e82cd9f69d6150 },
+    { 0x892731ac9faf056e, 0xbe311c083a225cd2 },
+    { 0xab70fe17c79ac6ca, 0x6dbd630a48aaf406 },
+    { 0xd64d3d9db981787d, 0x092cbbccdad5b108 },
+    { 0x85f0468293f0eb4e, 0x25bbf56008c58ea5 },
+    { 0xa76c582338ed2621, 0xaf2af2b80af6f24e },
+    { 0xd1476e2c07286faa, 0x1af5af660db4aee1 },
+    { 0x82cca4db847945ca, 0x50d98d9fc890ed4d },
+    { 0xa37fce126597973c, 0xe50ff107bab528a0 },
+    { 0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8 },
+    { 0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a },
+    { 0x9faacf3df73609b1, 0x77b191618c54e9ac },
+    { 0xc795830d75038c1d, 0xd59df5b9ef6a2417 },
+    { 0xf97ae3d0d2446f25, 0x4b0573286b44ad1d },
+    { 0x9becce62836ac577, 0x4ee367f9430aec32 },
+    { 0xc2e801fb244576d5, 0x229c41f793cda73f },
+    { 0xf3a20279ed56d48a, 0x6b43527578c1110f },
+    { 0x9845418c345644d6, 0x830a13896b78aaa9 },
+    { 0xbe5691ef416bd60c, 0x23cc986bc656d553 },
+    { 0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8 },
+    { 0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9 },
+    { 0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53 },
+    { 0xe858ad248f5c22c9, 0xd1b3400f8f9cff68 },
+    { 0x91376c36d99995be, 0x23100809b9c21fa1 },
+    { 0xb58547448ffffb2d, 0xabd40a0c2832a78a },
+    { 0xe2e69915b3fff9f9, 0x16c90c8f323f516c },
+    { 0x8dd01fad907ffc3b, 0xae3da7d97f6792e3 },
+    { 0xb1442798f49ffb4a, 0x99cd11cfdf41779c },
+    { 0xdd95317f31c7fa1d, 0x40405643d711d583 },
+    { 0x8a7d3eef7f1cfc52, 0x482835ea666b2572 },
+    { 0xad1c8eab5ee43b66, 0xda3243650005eecf },
+    { 0xd863b256369d4a40, 0x90bed43e40076a82 },
+    { 0x873e4f75e2224e68, 0x5a7744a6e804a291 },
+    { 0xa90de3535aaae202, 0x711515d0a205cb36 },
+    { 0xd3515c2831559a83, 0x0d5a5b44ca873e03 },
+    { 0x8412d9991ed58091, 0xe858790afe9486c2 },
+    { 0xa5178fff668ae0b6, 0x626e974dbe39a872 },
+    { 0xce5d73ff402d98e3, 0xfb0a3d212dc8128f },
+    { 0x80fa687f881c7f8e, 0x7ce66634bc9d0b99 },
+    { 0xa139029f6a239f72, 0x1c1fffc1ebc44e80 },
+    { 0xc987434744ac874e, 0xa327ffb266b56220 },
+    { 0xfbe9141915d7a922, 0x4bf1ff9f0062baa8 },
+    { 0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9 },
+    { 0xc4ce17b399107c22, 0xcb550fb4384d21d3 },
+    { 0xf6019da07f549b2b, 0x7e2a53a146606a48 },
+    { 0x99c102844f94e0fb, 0x2eda7444cbfc426d },
+    { 0xc0314325637a1939, 0xfa911155fefb5308 },
+    { 0xf03d93eebc589f88, 0x793555ab7eba27ca },
+    { 0x96267c7535b763b5, 0x4bc1558b2f3458de },
+    { 0xbbb01b9283253ca2, 0x9eb1aaedfb016f16 },
+    { 0xea9c227723ee8bcb, 0x465e15a979c1cadc },
+    { 0x92a1958a7675175f, 0x0bfacd89ec191ec9 },
+    { 0xb749faed14125d36, 0xcef980ec671f667b },
+    { 0xe51c79a85916f484, 0x82b7e12780e7401a },
+    { 0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810 },
+    { 0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15 },
+    { 0xdfbdcece67006ac9, 0x67a791e093e1d49a },
+    { 0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0 },
+    { 0xaecc49914078536d, 0x58fae9f773886e18 },
+    { 0xda7f5bf590966848, 0xaf39a475506a899e },
+    { 0x888f99797a5e012d, 0x6d8406c952429603 },
+    { 0xaab37fd7d8f58178, 0xc8e5087ba6d33b83 },
+    { 0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64 },
+    { 0x855c3be0a17fcd26, 0x5cf2eea09a55067f },
+    { 0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e },
+    { 0xd0601d8efc57b08b, 0xf13b94daf124da26 },
+    { 0x823c12795db6ce57, 0x76c53d08d6b70858 },
+    { 0xa2cb1717b52481ed, 0x54768c4b0c64ca6e },
+    { 0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09 },
+    { 0xfe5d54150b090b02, 0xd3f93b35435d7c4c },
+    { 0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf },
+    { 0xc6b8e9b0709f109a, 0x359ab6419ca1091b },
+    { 0xf867241c8cc6d4c0, 0xc30163d203c94b62 },
+    { 0x9b407691d7fc44f8, 0x79e0de63425dcf1d },
+    { 0xc21094364dfb5636, 0x985915fc12f542e4 },
+    { 0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d },
+    { 0x979cf3ca6cec5b5a, 0xa705992ceecf9c42 },
+    { 0xbd8430bd08277231, 0x50c6ff782a838353 },
+    { 0xece53cec4a314ebd, 0xa4f8bf5635246428 },
+    { 0x940f4613ae5ed136, 0x871b7795e136be99 },
+    { 0xb913179899f68584, 0x28e2557b59846e3f },
+    { 0xe757dd7ec07426e5, 0x331aeada2fe589cf },
+    { 0x9096ea6f3848984f, 0x3ff0d2c85def7621 },
+    { 0xb4bca50b065abe63, 0x0fed077a756b53a9 },
+    { 0xe1ebce4dc7f16dfb, 0xd3e8495912c62894 },
+    { 0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c },
+    { 0xb080392cc4349dec, 0xbd8d794d96aacfb3 },
+    { 0xdca04777f541c567, 0xecf0d7a0fc5583a0 },
+    { 0x89e42caaf9491b60, 0xf41686c49db57244 },
+    { 0xac5d37d5b79b6239, 0x311c2875c522ced5 },
+    { 0xd77485cb25823ac7, 0x7d633293366b828b },
+    { 0x86a8d39ef77164bc, 0xae5dff9c02033197 },
+    { 0xa8530886b54dbdeb, 0xd9f57f830283fdfc },
+    { 0xd267caa862a12d66, 0xd072df63c324fd7b },
+    { 0x8380dea93da4bc60, 0x4247cb9e59f71e6d },
+    { 0xa46116538d0deb78, 0x52d9be85f074e608 },
+    { 0xcd795be870516656, 0x67902e276c921f8b },
+    { 0x806bd9714632dff6, 0x00ba1cd8a3db53b6 },
+    { 0xa086cfcd97bf97f3, 0x80e8a40eccd228a4 },
+    { 0xc8a883c0fdaf7df0, 0x6122cd128006b2cd },
+    { 0xfad2a4b13d1b5d6c, 0x796b805720085f81 },
+    { 0x9cc3a6eec6311a63, 0xcbe3303674053bb0 },
+    { 0xc3f490aa77bd60fc, 0xbedbfc4411068a9c },
+    { 0xf4f1b4d515acb93b, 0xee92fb5515482d44 },
+    { 0x991711052d8bf3c5, 0x751bdd152d4d1c4a },
+    { 0xbf5cd54678eef0b6, 0xd262d45a78a0635d },
+    { 0xef340a98172aace4, 0x86fb897116c87c34 },
+    { 0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0 },
+    { 0xbae0a846d2195712, 0x8974836059cca109 },
+    { 0xe998d258869facd7, 0x2bd1a438703fc94b },
+    { 0x91ff83775423cc06, 0x7b6306a34627ddcf },
+    { 0xb67f6455292cbf08, 0x1a3bc84c17b1d542 },
+    { 0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93 },
+    { 0x8e938662882af53e, 0x547eb47b7282ee9c },
+    { 0xb23867fb2a35b28d, 0xe99e619a4f23aa43 },
+    { 0xdec681f9f4c31f31, 0x6405fa00e2ec94d4 },
+    { 0x8b3c113c38f9f37e, 0xde83bc408dd3dd04 },
+    { 0xae0b158b4738705e, 0x9624ab50b148d445 },
+    { 0xd98ddaee19068c76, 0x3badd624dd9b0957 },
+    { 0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6 },
+    { 0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c },
+    { 0xd47487cc8470652b, 0x7647c3200069671f },
+    { 0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073 },
+    { 0xa5fb0a17c777cf09, 0xf468107100525890 },
+    { 0xcf79cc9db955c2cc, 0x7182148d4066eeb4 },
+    { 0x81ac1fe293d599bf, 0xc6f14cd848405530 },
+    { 0xa21727db38cb002f, 0xb8ada00e5a506a7c },
+    { 0xca9cf1d206fdc03b, 0xa6d90811f0e4851c },
+    { 0xfd442e4688bd304a, 0x908f4a166d1da663 },
+    { 0x9e4a9cec15763e2e, 0x9a598e4e043287fe },
+    { 0xc5dd44271ad3cdba, 0x40eff1e1853f29fd },
+    { 0xf7549530e188c128, 0xd12bee59e68ef47c },
+    { 0x9a94dd3e8cf578b9, 0x82bb74f8301958ce },
+    { 0xc13a148e3032d6e7, 0xe36a52363c1faf01 },
+    { 0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1 },
+    { 0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9 },
+    { 0xbcb2b812db11a5de, 0x7415d448f6b6f0e7 },
+    { 0xebdf661791d60f56, 0x111b495b3464ad21 },
+    { 0x936b9fcebb25c995, 0xcab10dd900beec34 },
+    { 0xb84687c269ef3bfb, 0x3d5d514f40eea742 },
+    { 0xe65829b3046b0afa, 0x0cb4a5a3112a5112 },
+    { 0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab },
+    { 0xb3f4e093db73a093, 0x59ed216765690f56 },
+    { 0xe0f218b8d25088b8, 0x306869c13ec3532c },
+    { 0x8c974f7383725573, 0x1e414218c73a13fb },
+    { 0xafbd2350644eeacf, 0xe5d1929ef90898fa },
+    { 0xdbac6c247d62a583, 0xdf45f746b74abf39 },
+    { 0x894bc396ce5da772, 0x6b8bba8c328eb783 },
+    { 0xab9eb47c81f5114f, 0x066ea92f3f326564 },
+    { 0xd686619ba27255a2, 0xc80a537b0efefebd },
+    { 0x8613fd0145877585, 0xbd06742ce95f5f36 },
+    { 0xa798fc4196e952e7, 0x2c48113823b73704 },
+    { 0xd17f3b51fca3a7a0, 0xf75a15862ca504c5 },
+    { 0x82ef85133de648c4, 0x9a984d73dbe722fb },
+    { 0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba },
+    { 0xcc963fee10b7d1b3, 0x318df905079926a8 },
+    { 0xffbbcfe994e5c61f, 0xfdf17746497f7052 },
+    { 0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633 },
+    { 0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0 },
+    { 0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0 },
+    { 0x9c1661a651213e2d, 0x06bea10ca65c084e },
+    { 0xc31bfa0fe5698db8, 0x486e494fcff30a62 },
+    { 0xf3e2f893dec3f126, 0x5a89dba3c3efccfa },
+    { 0x986ddb5c6b3a76b7, 0xf89629465a75e01c },
+    { 0xbe89523386091465, 0xf6bbb397f1135823 },
+    { 0xee2ba6c0678b597f, 0x746aa07ded582e2c },
+    { 0x94db483840b717ef, 0xa8c2a44eb4571cdc },
+    { 0xba121a4650e4ddeb, 0x92f34d62616ce413 },
+    { 0xe896a0d7e51e1566, 0x77b020baf9c81d17 },
+    { 0x915e2486ef32cd60, 0x0ace1474dc1d122e },
+    { 0xb5b5ada8aaff80b8, 0x0d819992132456ba },
+    { 0xe3231912d5bf60e6, 0x10e1fff697ed6c69 },
+    { 0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1 },
+    { 0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2 },
+    { 0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde },
+    { 0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b },
+    { 0xad4ab7112eb3929d, 0x86c16c98d2c953c6 },
+    { 0xd89d64d57a607744, 0xe871c7bf077ba8b7 },
+    { 0x87625f056c7c4a8b, 0x11471cd764ad4972 },
+    { 0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf },
+    { 0xd389b47879823479, 0x4aff1d108d4ec2c3 },
+    { 0x843610cb4bf160cb, 0xcedf722a585139ba },
+    { 0xa54394fe1eedb8fe, 0xc2974eb4ee658828 },
+    { 0xce947a3da6a9273e, 0x733d226229feea32 },
+    { 0x811ccc668829b887, 0x0806357d5a3f525f },
+    { 0xa163ff802a3426a8, 0xca07c2dcb0cf26f7 },
+    { 0xc9bcff6034c13052, 0xfc89b393dd02f0b5 },
+    { 0xfc2c3f3841f17c67, 0xbbac2078d443ace2 },
+    { 0x9d9ba7832936edc0, 0xd54b944b84aa4c0d },
+    { 0xc5029163f384a931, 0x0a9e795e65d4df11 },
+    { 0xf64335bcf065d37d, 0x4d4617b5ff4a16d5 },
+    { 0x99ea0196163fa42e, 0x504bced1bf8e4e45 },
+    { 0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6 },
+    { 0xf07da27a82c37088, 0x5d767327bb4e5a4c },
+    { 0x964e858c91ba2655, 0x3a6a07f8d510f86f },
+    { 0xbbe226efb628afea, 0x890489f70a55368b },
+    { 0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e },
+    { 0x92c8ae6b464fc96f, 0x3b0b8bc90012929d },
+    { 0xb77ada0617e3bbcb, 0x09ce6ebb40173744 },
+    { 0xe55990879ddcaabd, 0xcc420a6a101d0515 },
+    { 0x8f57fa54c2a9eab6, 0x9fa946824a12232d },
+    { 0xb32df8e9f3546564, 0x47939822dc96abf9 },
+    { 0xdff9772470297ebd, 0x59787e2b93bc56f7 },
+    { 0x8bfbea76c619ef36, 0x57eb4edb3c55b65a },
+    { 0xaefae51477a06b03, 0xede622920b6b23f1 },
+    { 0xdab99e59958885c4, 0xe95fab368e45eced },
+    { 0x88b402f7fd75539b, 0x11dbcb0218ebb414 },
+    { 0xaae103b5fcd2a881, 0xd652bdc29f26a119 },
+    { 0xd59944a37c0752a2, 0x4be76d3346f0495f },
+    { 0x857fcae62d8493a5, 0x6f70a4400c562ddb },
+    { 0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952 },
+    { 0xd097ad07a71f26b2, 0x7e2000a41346a7a7 },
+    { 0x825ecc24c873782f, 0x8ed400668c0c28c8 },
+    { 0xa2f67f2dfa90563b, 0x728900802f0f32fa },
+    { 0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9 },
+    { 0xfea126b7d78186bc, 0xe2f610c84987bfa8 },
+    { 0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9 },
+    { 0xc6ede63fa05d3143, 0x91503d1c79720dbb },
+    { 0xf8a95fcf88747d94, 0x75a44c6397ce912a },
+    { 0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba },
+    { 0xc24452da229b021b, 0xfbe85badce996168 },
+    { 0xf2d56790ab41c2a2, 0xfae27299423fb9c3 },
+    { 0x97c560ba6b0919a5, 0xdccd879fc967d41a },
+    { 0xbdb6b8e905cb600f, 0x5400e987bbc1c920 },
+    { 0xed246723473e3813, 0x290123e9aab23b68 },
+    { 0x9436c0760c86e30b, 0xf9a0b6720aaf6521 },
+    { 0xb94470938fa89bce, 0xf808e40e8d5b3e69 },
+    { 0xe7958cb87392c2c2, 0xb60b1d1230b20e04 },
+    { 0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2 },
+    { 0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3 },
+    { 0xe2280b6c20dd5232, 0x25c6da63c38de1b0 },
+    { 0x8d590723948a535f, 0x579c487e5a38ad0e },
+    { 0xb0af48ec79ace837, 0x2d835a9df0c6d851 },
+    { 0xdcdb1b2798182244, 0xf8e431456cf88e65 },
+    { 0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff },
+    { 0xac8b2d36eed2dac5, 0xe272467e3d222f3f },
+    { 0xd7adf884aa879177, 0x5b0ed81dcc6abb0f },
+    { 0x86ccbb52ea94baea, 0x98e947129fc2b4e9 },
+    { 0xa87fea27a539e9a5, 0x3f2398d747b36224 },
+    { 0xd29fe4b18e88640e, 0x8eec7f0d19a03aad },
+    { 0x83a3eeeef9153e89, 0x1953cf68300424ac },
+    { 0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7 },
+    { 0xcdb02555653131b6, 0x3792f412cb06794d },
+    { 0x808e17555f3ebf11, 0xe2bbd88bbee40bd0 },
+    { 0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4 },
+    { 0xc8de047564d20a8b, 0xf245825a5a445275 },
+    { 0xfb158592be068d2e, 0xeed6e2f0f0d56712 },
+    { 0x9ced737bb6c4183d, 0x55464dd69685606b },
+    { 0xc428d05aa4751e4c, 0xaa97e14c3c26b886 },
+    { 0xf53304714d9265df, 0xd53dd99f4b3066a8 },
+    { 0x993fe2c6d07b7fab, 0xe546a8038efe4029 },
+    { 0xbf8fdb78849a5f96, 0xde98520472bdd033 },
+    { 0xef73d256a5c0f77c, 0x963e66858f6d4440 },
+    { 0x95a8637627989aad, 0xdde7001379a44aa8 },
+    { 0xbb127c53b17ec159, 0x5560c018580d5d52 },
+    { 0xe9d71b689dde71af, 0xaab8f01e6e10b4a6 },
+    { 0x9226712162ab070d, 0xcab3961304ca70e8 },
+    { 0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22 },
+    { 0xe45c10c42a2b3b05, 0x8cb89a7db77c506a },
+    { 0x8eb98a7a9a5b04e3, 0x77f3608e92adb242 },
+    { 0xb267ed1940f1c61c, 0x55f038b237591ed3 },
+    { 0xdf01e85f912e37a3, 0x6b6c46dec52f6688 },
+    { 0x8b61313bbabce2c6, 0x2323ac4b3b3da015 },
+    { 0xae397d8aa96c1b77, 0xabec975e0a0d081a },
+    { 0xd9c7dced53c72255, 0x96e7bd358c904a21 },
+    { 0x881cea14545c7575, 0x7e50d64177da2e54 },
+    { 0xaa242499697392d2, 0xdde50bd1d5d0b9e9 },
+    { 0xd4ad2dbfc3d07787, 0x955e4ec64b44e864 },
+    { 0x84ec3c97da624ab4, 0xbd5af13bef0b113e },
+    { 0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e },
+    { 0xcfb11ead453994ba, 0x67de18eda5814af2 },
+    { 0x81ceb32c4b43fcf4, 0x80eacf948770ced7 },
+    { 0xa2425ff75e14fc31, 0xa1258379a94d028d },
+    { 0xcad2f7f5359a3b3e, 0x096ee45813a04330 },
+    { 0xfd87b5f28300ca0d, 0x8bca9d6e188853fc },
+    { 0x9e74d1b791e07e48, 0x775ea264cf55347d },
+    { 0xc612062576589dda, 0x95364afe032a819d },
+    { 0xf79687aed3eec551, 0x3a83ddbd83f52204 },
+    { 0x9abe14cd44753b52, 0xc4926a9672793542 },
+    { 0xc16d9a0095928a27, 0x75b7053c0f178293 },
+    { 0xf1c90080baf72cb1, 0x5324c68b12dd6338 },
+    { 0x971da05074da7bee, 0xd3f6fc16ebca5e03 },
+    { 0xbce5086492111aea, 0x88f4bb1ca6bcf584 },
+    { 0xec1e4a7db69561a5, 0x2b31e9e3d06c32e5 },
+    { 0x9392ee8e921d5d07, 0x3aff322e62439fcf },
+    { 0xb877aa3236a4b449, 0x09befeb9fad487c2 },
+    { 0xe69594bec44de15b, 0x4c2ebe687989a9b3 },
+    { 0x901d7cf73ab0acd9, 0x0f9d37014bf60a10 },
+    { 0xb424dc35095cd80f, 0x538484c19ef38c94 },
+    { 0xe12e13424bb40e13, 0x2865a5f206b06fb9 },
+    { 0x8cbccc096f5088cb, 0xf93f87b7442e45d3 },
+    { 0xafebff0bcb24aafe, 0xf78f69a51539d748 },
+    { 0xdbe6fecebdedd5be, 0xb573440e5a884d1b },
+    { 0x89705f4136b4a597, 0x31680a88f8953030 },
+    { 0xabcc77118461cefc, 0xfdc20d2b36ba7c3d },
+    { 0xd6bf94d5e57a42bc, 0x3d32907604691b4c },
+    { 0x8637bd05af6c69b5, 0xa63f9a49c2c1b10f },
+    { 0xa7c5ac471b478423, 0x0fcf80dc33721d53 },
+    { 0xd1b71758e219652b, 0xd3c36113404ea4a8 },
+    { 0x83126e978d4fdf3b, 0x645a1cac083126e9 },
+    { 0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a3 },
+    { 0xcccccccccccccccc, 0xcccccccccccccccc },
+    { 0x8000000000000000, 0x0000000000000000 },
+    { 0xa000000000000000, 0x0000000000000000 },
+    { 0xc800000000000000, 0x0000000000000000 },
+    { 0xfa00000000000000, 0x0000000000000000 },
+    { 0x9c40000000000000, 0x0000000000000000 },
+    { 0xc350000000000000, 0x0000000000000000 },
+    { 0xf424000000000000, 0x0000000000000000 },
+    { 0x9896800000000000, 0x0000000000000000 },
+    { 0xbebc200000000000, 0x0000000000000000 },
+    { 0xee6b280000000000, 0x0000000000000000 },
+    { 0x9502f90000000000, 0x0000000000000000 },
+    { 0xba43b74000000000, 0x0000000000000000 },
+    { 0xe8d4a51000000000, 0x0000000000000000 },
+    { 0x9184e72a00000000, 0x0000000000000000 },
+    { 0xb5e620f480000000, 0x0000000000000000 },
+    { 0xe35fa931a0000000, 0x0000000000000000 },
+    { 0x8e1bc9bf04000000, 0x0000000000000000 },
+    { 0xb1a2bc2ec5000000, 0x0000000000000000 },
+    { 0xde0b6b3a76400000, 0x0000000000000000 },
+    { 0x8ac7230489e80000, 0x0000000000000000 },
+    { 0xad78ebc5ac620000, 0x0000000000000000 },
+    { 0xd8d726b7177a8000, 0x0000000000000000 },
+    { 0x878678326eac9000, 0x0000000000000000 },
+    { 0xa968163f0a57b400, 0x0000000000000000 },
+    { 0xd3c21bcecceda100, 0x0000000000000000 },
+    { 0x84595161401484a0, 0x0000000000000000 },
+    { 0xa56fa5b99019a5c8, 0x0000000000000000 },
+    { 0xcecb8f27f4200f3a, 0x0000000000000000 },
+    { 0x813f3978f8940984, 0x4000000000000000 },
+    { 0xa18f07d736b90be5, 0x5000000000000000 },
+    { 0xc9f2c9cd04674ede, 0xa400000000000000 },
+    { 0xfc6f7c4045812296, 0x4d00000000000000 },
+    { 0x9dc5ada82b70b59d, 0xf020000000000000 },
+    { 0xc5371912364ce305, 0x6c28000000000000 },
+    { 0xf684df56c3e01bc6, 0xc732000000000000 },
+    { 0x9a130b963a6c115c, 0x3c7f400000000000 },
+    { 0xc097ce7bc90715b3, 0x4b9f100000000000 },
+    { 0xf0bdc21abb48db20, 0x1e86d40000000000 },
+    { 0x96769950b50d88f4, 0x1314448000000000 },
+    { 0xbc143fa4e250eb31, 0x17d955a000000000 },
+    { 0xeb194f8e1ae525fd, 0x5dcfab0800000000 },
+    { 0x92efd1b8d0cf37be, 0x5aa1cae500000000 },
+    { 0xb7abc627050305ad, 0xf14a3d9e40000000 },
+    { 0xe596b7b0c643c719, 0x6d9ccd05d0000000 },
+    { 0x8f7e32ce7bea5c6f, 0xe4820023a2000000 },
+    { 0xb35dbf821ae4f38b, 0xdda2802c8a800000 },
+    { 0xe0352f62a19e306e, 0xd50b2037ad200000 },
+    { 0x8c213d9da502de45, 0x4526f422cc340000 },
+    { 0xaf298d050e4395d6, 0x9670b12b7f410000 },
+    { 0xdaf3f04651d47b4c, 0x3c0cdd765f114000 },
+    { 0x88d8762bf324cd0f, 0xa5880a69fb6ac800 },
+    { 0xab0e93b6efee0053, 0x8eea0d047a457a00 },
+    { 0xd5d238a4abe98068, 0x72a4904598d6d880 },
+    { 0x85a36366eb71f041, 0x47a6da2b7f864750 },
+    { 0xa70c3c40a64e6c51, 0x999090b65f67d924 },
+    { 0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d },
+    { 0x82818f1281ed449f, 0xbff8f10e7a8921a4 },
+    { 0xa321f2d7226895c7, 0xaff72d52192b6a0d },
+    { 0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490 },
+    { 0xfee50b7025c36a08, 0x02f236d04753d5b4 },
+    { 0x9f4f2726179a2245, 0x01d762422c946590 },
+    { 0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5 },
+    { 0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2 },
+    { 0x9b934c3b330c8577, 0x63cc55f49f88eb2f },
+    { 0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb },
+    { 0xf316271c7fc3908a, 0x8bef464e3945ef7a },
+    { 0x97edd871cfda3a56, 0x97758bf0e3cbb5ac },
+    { 0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317 },
+    { 0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd },
+    { 0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a },
+    { 0xb975d6b6ee39e436, 0xb3e2fd538e122b44 },
+    { 0xe7d34c64a9c85d44, 0x60dbbca87196b616 },
+    { 0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd },
+    { 0xb51d13aea4a488dd, 0x6babab6398bdbe41 },
+    { 0xe264589a4dcdab14, 0xc696963c7eed2dd1 },
+    { 0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2 },
+    { 0xb0de65388cc8ada8, 0x3b25a55f43294bcb },
+    { 0xdd15fe86affad912, 0x49ef0eb713f39ebe },
+    { 0x8a2dbf142dfcc7ab, 0x6e3569326c784337 },
+    { 0xacb92ed9397bf996, 0x49c2c37f07965404 },
+    { 0xd7e77a8f87daf7fb, 0xdc33745ec97be906 },
+    { 0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3 },
+    { 0xa8acd7c0222311bc, 0xc40832ea0d68ce0c },
+    { 0xd2d80db02aabd62b, 0xf50a3fa490c30190 },
+    { 0x83c7088e1aab65db, 0x792667c6da79e0fa },
+    { 0xa4b8cab1a1563f52, 0x577001b891185938 },
+    { 0xcde6fd5e09abcf26, 0xed4c0226b55e6f86 },
+    { 0x80b05e5ac60b6178, 0x544f8158315b05b4 },
+    { 0xa0dc75f1778e39d6, 0x696361ae3db1c721 },
+    { 0xc913936dd571c84c, 0x03bc3a19cd1e38e9 },
+    { 0xfb5878494ace3a5f, 0x04ab48a04065c723 },
+    { 0x9d174b2dcec0e47b, 0x62eb0d64283f9c76 },
+    { 0xc45d1df942711d9a, 0x3ba5d0bd324f8394 },
+    { 0xf5746577930d6500, 0xca8f44ec7ee36479 },
+    { 0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb },
+    { 0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e },
+    { 0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e },
+    { 0x95d04aee3b80ece5, 0xbba1f1d158724a12 },
+    { 0xbb445da9ca61281f, 0x2a8a6e45ae8edc97 },
+    { 0xea1575143cf97226, 0xf52d09d71a3293bd },
+    { 0x924d692ca61be758, 0x593c2626705f9c56 },
+    { 0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c },
+    { 0xe498f455c38b997a, 0x0b6dfb9c0f956447 },
+    { 0x8edf98b59a373fec, 0x4724bd4189bd5eac },
+    { 0xb2977ee300c50fe7, 0x58edec91ec2cb657 },
+    { 0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed },
+    { 0x8b865b215899f46c, 0xbd79e0d20082ee74 },
+    { 0xae67f1e9aec07187, 0xecd8590680a3aa11 },
+    { 0xda01ee641a708de9, 0xe80e6f4820cc9495 },
+    { 0x884134fe908658b2, 0x3109058d147fdcdd },
+    { 0xaa51823e34a7eede, 0xbd4b46f0599fd415 },
+    { 0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a },
+    { 0x850fadc09923329e, 0x03e2cf6bc604ddb0 },
+    { 0xa6539930bf6bff45, 0x84db8346b786151c },
+    { 0xcfe87f7cef46ff16, 0xe612641865679a63 },
+    { 0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e },
+    { 0xa26da3999aef7749, 0xe3be5e330f38f09d },
+    { 0xcb090c8001ab551c, 0x5cadf5bfd3072cc5 },
+    { 0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6 },
+    { 0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa },
+    { 0xc646d63501a1511d, 0xb281e1fd541501b8 },
+    { 0xf7d88bc24209a565, 0x1f225a7ca91a4226 },
+    { 0x9ae757596946075f, 0x3375788de9b06958 },
+    { 0xc1a12d2fc3978937, 0x0052d6b1641c83ae },
+    { 0xf209787bb47d6b84, 0xc0678c5dbd23a49a },
+    { 0x9745eb4d50ce6332, 0xf840b7ba963646e0 },
+    { 0xbd176620a501fbff, 0xb650e5a93bc3d898 },
+    { 0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe },
+    { 0x93ba47c980e98cdf, 0xc66f336c36b10137 },
+    { 0xb8a8d9bbe123f017, 0xb80b0047445d4184 },
+    { 0xe6d3102ad96cec1d, 0xa60dc059157491e5 },
+    { 0x9043ea1ac7e41392, 0x87c89837ad68db2f },
+    { 0xb454e4a179dd1877, 0x29babe4598c311fb },
+    { 0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a },
+    { 0x8ce2529e2734bb1d, 0x1899e4a65f58660c },
+    { 0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f },
+    { 0xdc21a1171d42645d, 0x76707543f4fa1f73 },
+    { 0x899504ae72497eba, 0x6a06494a791c53a8 },
+    { 0xabfa45da0edbde69, 0x0487db9d17636892 },
+    { 0xd6f8d7509292d603, 0x45a9d2845d3c42b6 },
+    { 0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2 },
+    { 0xa7f26836f282b732, 0x8e6cac7768d7141e },
+    { 0xd1ef0244af2364ff, 0x3207d795430cd926 },
+    { 0x8335616aed761f1f, 0x7f44e6bd49e807b8 },
+    { 0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6 },
+    { 0xcd036837130890a1, 0x36dba887c37a8c0f },
+    { 0x802221226be55a64, 0xc2494954da2c9789 },
+    { 0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c },
+    { 0xc83553c5c8965d3d, 0x6f92829494e5acc7 },
+    { 0xfa42a8b73abbf48c, 0xcb772339ba1f17f9 },
+    { 0x9c69a97284b578d7, 0xff2a760414536efb },
+    { 0xc38413cf25e2d70d, 0xfef5138519684aba },
+    { 0xf46518c2ef5b8cd1, 0x7eb258665fc25d69 },
+    { 0x98bf2f79d5993802, 0xef2f773ffbd97a61 },
+    { 0xbeeefb584aff8603, 0xaafb550ffacfd8fa },
+    { 0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38 },
+    { 0x952ab45cfa97a0b2, 0xdd945a747bf26183 },
+    { 0xba756174393d88df, 0x94f971119aeef9e4 },
+    { 0xe912b9d1478ceb17, 0x7a37cd5601aab85d },
+    { 0x91abb422ccb812ee, 0xac62e055c10ab33a },
+    { 0xb616a12b7fe617aa, 0x577b986b314d6009 },
+    { 0xe39c49765fdf9d94, 0xed5a7e85fda0b80b },
+    { 0x8e41ade9fbebc27d, 0x14588f13be847307 },
+    { 0xb1d219647ae6b31c, 0x596eb2d8ae258fc8 },
+    { 0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb },
+    { 0x8aec23d680043bee, 0x25de7bb9480d5854 },
+    { 0xada72ccc20054ae9, 0xaf561aa79a10ae6a },
+    { 0xd910f7ff28069da4, 0x1b2ba1518094da04 },
+    { 0x87aa9aff79042286, 0x90fb44d2f05d0842 },
+    { 0xa99541bf57452b28, 0x353a1607ac744a53 },
+    { 0xd3fa922f2d1675f2, 0x42889b8997915ce8 },
+    { 0x847c9b5d7c2e09b7, 0x69956135febada11 },
+    { 0xa59bc234db398c25, 0x43fab9837e699095 },
+    { 0xcf02b2c21207ef2e, 0x94f967e45e03f4bb },
+    { 0x8161afb94b44f57d, 0x1d1be0eebac278f5 },
+    { 0xa1ba1ba79e1632dc, 0x6462d92a69731732 },
+    { 0xca28a291859bbf93, 0x7d7b8f7503cfdcfe },
+    { 0xfcb2cb35e702af78, 0x5cda735244c3d43e },
+    { 0x9defbf01b061adab, 0x3a0888136afa64a7 },
+    { 0xc56baec21c7a1916, 0x088aaa1845b8fdd0 },
+    { 0xf6c69a72a3989f5b, 0x8aad549e57273d45 },
+    { 0x9a3c2087a63f6399, 0x36ac54e2f678864b },
+    { 0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd },
+    { 0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5 },
+    { 0x969eb7c47859e743, 0x9f644ae5a4b1b325 },
+    { 0xbc4665b596706114, 0x873d5d9f0dde1fee },
+    { 0xeb57ff22fc0c7959, 0xa90cb506d155a7ea },
+    { 0x9316ff75dd87cbd8, 0x09a7f12442d588f2 },
+    { 0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f },
+    { 0xe5d3ef282a242e81, 0x8f1668c8a86da5fa },
+    { 0x8fa475791a569d10, 0xf96e017d694487bc },
+    { 0xb38d92d760ec4455, 0x37c981dcc395a9ac },
+    { 0xe070f78d3927556a, 0x85bbe253f47b1417 },
+    { 0x8c469ab843b89562, 0x93956d7478ccec8e },
+    { 0xaf58416654a6babb, 0x387ac8d1970027b2 },
+    { 0xdb2e51bfe9d0696a, 0x06997b05fcc0319e },
+    { 0x88fcf317f22241e2, 0x441fece3bdf81f03 },
+    { 0xab3c2fddeeaad25a, 0xd527e81cad7626c3 },
+    { 0xd60b3bd56a5586f1, 0x8a71e223d8d3b074 },
+    { 0x85c7056562757456, 0xf6872d5667844e49 },
+    { 0xa738c6bebb12d16c, 0xb428f8ac016561db },
+    { 0xd106f86e69d785c7, 0xe13336d701beba52 },
+    { 0x82a45b450226b39c, 0xecc0024661173473 },
+    { 0xa34d721642b06084, 0x27f002d7f95d0190 },
+    { 0xcc20ce9bd35c78a5, 0x31ec038df7b441f4 },
+    { 0xff290242c83396ce, 0x7e67047175a15271 },
+    { 0x9f79a169bd203e41, 0x0f0062c6e984d386 },
+    { 0xc75809c42c684dd1, 0x52c07b78a3e60868 },
+    { 0xf92e0c3537826145, 0xa7709a56ccdf8a82 },
+    { 0x9bbcc7a142b17ccb, 0x88a66076400bb691 },
+    { 0xc2abf989935ddbfe, 0x6acff893d00ea435 },
+    { 0xf356f7ebf83552fe, 0x0583f6b8c4124d43 },
+    { 0x98165af37b2153de, 0xc3727a337a8b704a },
+    { 0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c },
+    { 0xeda2ee1c7064130c, 0x1162def06f79df73 },
+    { 0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8 },
+    { 0xb9a74a0637ce2ee1, 0x6d953e2bd7173692 },
+    { 0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437 },
+    { 0x910ab1d4db9914a0, 0x1d9c9892400a22a2 },
+    { 0xb54d5e4a127f59c8, 0x2503beb6d00cab4b },
+    { 0xe2a0b5dc971f303a, 0x2e44ae64840fd61d },
+    { 0x8da471a9de737e24, 0x5ceaecfed289e5d2 },
+    { 0xb10d8e1456105dad, 0x7425a83e872c5f47 },
+    { 0xdd50f1996b947518, 0xd12f124e28f77719 },
+    { 0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f },
+    { 0xace73cbfdc0bfb7b, 0x636cc64d1001550b },
+    { 0xd8210befd30efa5a, 0x3c47f7e05401aa4e },
+    { 0x8714a775e3e95c78, 0x65acfaec34810a71 },
+    { 0xa8d9d1535ce3b396, 0x7f1839a741a14d0d },
+    { 0xd31045a8341ca07c, 0x1ede48111209a050 },
+    { 0x83ea2b892091e44d, 0x934aed0aab460432 },
+    { 0xa4e4b66b68b65d60, 0xf81da84d5617853f },
+    { 0xce1de40642e3f4b9, 0x36251260ab9d668e },
+    { 0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019 },
+    { 0xa1075a24e4421730, 0xb24cf65b8612f81f },
+    { 0xc94930ae1d529cfc, 0xdee033f26797b627 },
+    { 0xfb9b7cd9a4a7443c, 0x169840ef017da3b1 },
+    { 0x9d412e0806e88aa5, 0x8e1f289560ee864e },
+    { 0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2 },
+    { 0xf5b5d7ec8acb58a2, 0xae10af696774b1db },
+    { 0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29 },
+    { 0xbff610b0cc6edd3f, 0x17fd090a58d32af3 },
+    { 0xeff394dcff8a948e, 0xddfc4b4cef07f5b0 },
+    { 0x95f83d0a1fb69cd9, 0x4abdaf101564f98e },
+    { 0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1 },
+    { 0xea53df5fd18d5513, 0x84c86189216dc5ed },
+    { 0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4 },
+    { 0xb7118682dbb66a77, 0x3fbc8c33221dc2a1 },
+    { 0xe4d5e82392a40515, 0x0fabaf3feaa5334a },
+    { 0x8f05b1163ba6832d, 0x29cb4d87f2a7400e },
+    { 0xb2c71d5bca9023f8, 0x743e20e9ef511012 },
+    { 0xdf78e4b2bd342cf6, 0x914da9246b255416 },
+    { 0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e },
+    { 0xae9672aba3d0c320, 0xa184ac2473b529b1 },
+    { 0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e },
+    { 0x8865899617fb1871, 0x7e2fa67c7a658892 },
+    { 0xaa7eebfb9df9de8d, 0xddbb901b98feeab7 },
+    { 0xd51ea6fa85785631, 0x552a74227f3ea565 },
+    { 0x8533285c936b35de, 0xd53a88958f87275f },
+    { 0xa67ff273b8460356, 0x8a892abaf368f137 },
+    { 0xd01fef10a657842c, 0x2d2b7569b0432d85 },
+    { 0x8213f56a67f6b29b, 0x9c3b29620e29fc73 },
+    { 0xa298f2c501f45f42, 0x8349f3ba91b47b8f },
+    { 0xcb3f2f7642717713, 0x241c70a936219a73 },
+    { 0xfe0efb53d30dd4d7, 0xed238cd383aa0110 },
+    { 0x9ec95d1463e8a506, 0xf4363804324a40aa },
+    { 0xc67bb4597ce2ce48, 0xb143c6053edcd0d5 },
+    { 0xf81aa16fdc1b81da, 0xdd94b7868e94050a },
+    { 0x9b10a4e5e9913128, 0xca7cf2b4191c8326 },
+    { 0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0 },
+    { 0xf24a01a73cf2dccf, 0xbc633b39673c8cec },
+    { 0x976e41088617ca01, 0xd5be0503e085d813 },
+    { 0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18 },
+    { 0xec9c459d51852ba2, 0xddf8e7d60ed1219e },
+    { 0x93e1ab8252f33b45, 0xcabb90e5c942b503 },
+    { 0xb8da1662e7b00a17, 0x3d6a751f3b936243 },
+    { 0xe7109bfba19c0c9d, 0x0cc512670a783ad4 },
+    { 0x906a617d450187e2, 0x27fb2b80668b24c5 },
+    { 0xb484f9dc9641e9da, 0xb1f9f660802dedf6 },
+    { 0xe1a63853bbd26451, 0x5e7873f8a0396973 },
+    { 0x8d07e33455637eb2, 0xdb0b487b6423e1e8 },
+    { 0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62 },
+    { 0xdc5c5301c56b75f7, 0x7641a140cc7810fb },
+    { 0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d },
+    { 0xac2820d9623bf429, 0x546345fa9fbdcd44 },
+    { 0xd732290fbacaf133, 0xa97c177947ad4095 },
+    { 0x867f59a9d4bed6c0, 0x49ed8eabcccc485d },
+    { 0xa81f301449ee8c70, 0x5c68f256bfff5a74 },
+    { 0xd226fc195c6a2f8c, 0x73832eec6fff3111 },
+    { 0x83585d8fd9c25db7, 0xc831fd53c5ff7eab },
+    { 0xa42e74f3d032f525, 0xba3e7ca8b77f5e55 },
+    { 0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb },
+    { 0x80444b5e7aa7cf85, 0x7980d163cf5b81b3 },
+    { 0xa0555e361951c366, 0xd7e105bcc332621f },
+    { 0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7 },
+    { 0xfa856334878fc150, 0xb14f98f6f0feb951 },
+    { 0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3 },
+    { 0xc3b8358109e84f07, 0x0a862f80ec4700c8 },
+    { 0xf4a642e14c6262c8, 0xcd27bb612758c0fa },
+    { 0x98e7e9cccfbd7dbd, 0x8038d51cb897789c },
+    { 0xbf21e44003acdd2c, 0xe0470a63e6bd56c3 },
+    { 0xeeea5d5004981478, 0x1858ccfce06cac74 },
+    { 0x95527a5202df0ccb, 0x0f37801e0c43ebc8 },
+    { 0xbaa718e68396cffd, 0xd30560258f54e6ba },
+    { 0xe950df20247c83fd, 0x47c6b82ef32a2069 },
+    { 0x91d28b7416cdd27e, 0x4cdc331d57fa5441 },
+    { 0xb6472e511c81471d, 0xe0133fe4adf8e952 },
+    { 0xe3d8f9e563a198e5, 0x58180fddd97723a6 },
+    { 0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648 }
+};
+
+/**
+ * Powers of ten which are exact doubles.
+ */
+static const double jsmn_pow10_exact[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+    1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * A number split up into its first 19 significant digits and an exponent.
+ */
+typedef struct {
+    uint64_t man;   // Significant digits
+    int exp10;      // Exponent of 'man'
+    int neg;        // Minus sign
+    int trunc;      // Non-zero digits have been dropped from 'man'
+} jsmn_Number;
+
+/**
+ * Splits up the number of 'len' bytes at 's'. Returns 0 or JSMN_ERROR_INVAL,
+ * if it is not a number according to the JSON grammar.
+ */
+static int jsmn_scan_number(const char *s, int len, jsmn_Number *num)
+{
+    int i = 0;
+    int digits = 0;
+    int exp = 0;
+    int expneg = 0;
+
+    num->man = 0;
+    num->exp10 = 0;
+    num->neg = 0;
+    num->trunc = 0;
+    if (i < len && s[i] == '-') {
+        num->neg = 1;
+        i++;
+    }
+    if (i >= len || s[i] < '0' || s[i] > '9') {
+        return JSMN_ERROR_INVAL;
+    }
+    if (s[i] == '0') {
+        i++;
+    } else {
+        for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+            if (digits < 19) {
+                num->man = num->man * 10 + (s[i] - '0');
+                digits++;
+            } else {
+                // Dropped digits of the integer part scale 'man'
+                num->exp10++;
+                if (s[i] != '0') num->trunc = 1;
+            }
+        }
+    }
+    if (i < len && s[i] == '.') {
+        i++;
+        if (i >= len || s[i] < '0' || s[i] > '9') {
+            return JSMN_ERROR_INVAL;
+        }
+        for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+            if (digits < 19) {
+                num->man = num->man * 10 + (s[i] - '0');
+                num->exp10--;
+                // Leading zeros are not significant
+                if (num->man != 0) digits++;
+            } else if (s[i] != '0') {
+                num->trunc = 1;
+            }
+        }
+    }
+    if (i < len && (s[i] == 'e' || s[i] == 'E')) {
+        i++;
+        if (i < len && (s[i] == '+' || s[i] == '-')) {
+            expneg = s[i] == '-';
+            i++;
+        }
+        if (i >= len || s[i] < '0' || s[i] > '9') {
+            return JSMN_ERROR_INVAL;
+        }
+        for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+            // Saturate, the result is zero or infinite long before
+            if (exp < 100000) exp = exp * 10 + (s[i] - '0');
+        }
+        num->exp10 += expneg ? -exp : exp;
+    }
+    return i == len ? 0 : JSMN_ERROR_INVAL;
+}
+
+/**
+ * Multiplies 'a' by 'b', returns the high 64 bits of the product and stores
+ * the low ones in 'lo'.
+ */
+static uint64_t jsmn_mul128(uint64_t a, uint64_t b, uint64_t *lo)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *lo = (uint64_t)r;
+    return (uint64_t)(r >> 64);
+#else
+    uint64_t a0 = a & 0xffffffff, a1 = a >> 32;
+    uint64_t b0 = b & 0xffffffff, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+    *lo = (mid << 32) | (p00 & 0xffffffff);
+    return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+/**
+ * Counts the leading zero bits of 'x', which must not be 0.
+ */
+static int jsmn_clz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x >> 63)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Converts 'man' * 10^'exp10' to the bits of a positive double with the
+ * Eisel-Lemire algorithm. Returns -1, if the rounding cannot be decided this
+ * way or the result is subnormal or infinite.
+ */
+static int jsmn_eisel_lemire(uint64_t man, int exp10, uint64_t *bits)
+{
+    const uint64_t *pow;
+    uint64_t xhi, xlo, mant;
+    int exp2, clz, msb;
+
+    if (man == 0) {
+        *bits = 0;
+        return 0;
+    }
+    if (exp10 < JSMN_POW10_MIN || exp10 > JSMN_POW10_MAX) {
+        return -1;
+    }
+    clz = jsmn_clz64(man);
+    man <<= clz;
+    // floor(exp10 * log2(10)) for the exponents in the table
+    exp2 = 217706 * exp10;
+    exp2 = (exp2 >= 0 ? exp2 : exp2 - 65535) / 65536;
+    exp2 += 64 + 1023 - clz;
+    pow = jsmn_pow10[exp10 - JSMN_POW10_MIN];
+    xhi = jsmn_mul128(man, pow[0], &xlo);
+    if ((xhi & 0x1ff) == 0x1ff && xlo + man < man) {
+        // Truncating the power of ten might have changed the result
+        uint64_t yhi, ylo, mhi, mlo;
+        yhi = jsmn_mul128(man, pow[1], &ylo);
+        mhi = xhi;
+        mlo = xlo + yhi;
+        if (mlo < xlo) mhi++;
+        if ((mhi & 0x1ff) == 0x1ff && mlo + 1 == 0 && ylo + man < man) {
+            return -1;
+        }
+        xhi = mhi;
+        xlo = mlo;
+    }
+    msb = (int)(xhi >> 63);
+    mant = xhi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+    if (xlo == 0 && (xhi & 0x1ff) == 0 && (mant & 3) == 1) {
+        // Exactly halfway between two doubles
+        return -1;
+    }
+    mant += mant & 1;
+    mant >>= 1;
+    if (mant >> 53) {
+        mant >>= 1;
+        exp2++;
+    }
+    if (exp2 <= 0 || exp2 >= 0x7ff) {
+        return -1;
+    }
+    *bits = (uint64_t)exp2 << 52 | (mant & 0xfffffffffffff);
+    return 0;
+}
+
+/**
+ * Arbitrary precision decimal used when Eisel-Lemire gives up. The digits are
+ * 0.d[0]d[1]...d[nd-1] * 10^dp.
+ */
+#define JSMN_DECIMAL_DIGITS 800
+typedef struct {
+    unsigned char d[JSMN_DECIMAL_DIGITS];   // Digits, most significant first
+    int nd;         // Number of digits
+    int dp;         // Position of the decimal point
+    int trunc;      // Non-zero digits have been dropped
+} jsmn_Decimal;
+
+/**
+ * Removes trailing zeros.
+ */
+static void jsmn_decimal_trim(jsmn_Decimal *a)
+{
+    while (a->nd > 0 && a->d[a->nd - 1] == 0) {
+        a->nd--;
+    }
+    if (a->nd == 0) a->dp = 0;
+}
+
+/**
+ * Reads the digits of the number 's', which has been checked already.
+ */
+static void jsmn_decimal_init(jsmn_Decimal *a, const char *s, int len)
+{
+    int i = 0;
+    int exp = 0;
+    int expneg = 0;
+    int point = 0;
+
+    a->nd = 0;
+    a->dp = 0;
+    a->trunc = 0;
+    if (s[i] == '-') i++;
+    for (; i < len && s[i] != 'e' && s[i] != 'E'; i++) {
+        if (s[i] == '.') {
+            point = 1;
+            continue;
+        }
+        if (!point) a->dp++;
+        if (s[i] == '0' && a->nd == 0) {
+            // Leading zeros only move the decimal point
+            a->dp--;
+        } else if (a->nd < JSMN_DECIMAL_DIGITS) {
+            a->d[a->nd++] = s[i] - '0';
+        } else if (s[i] != '0') {
+            a->trunc = 1;
+        }
+    }
+    if (i < len) {
+        i++;
+        if (s[i] == '+' || s[i] == '-') {
+            expneg = s[i] == '-';
+            i++;
+        }
+        for (; i < len; i++) {
+            if (exp < 100000) exp = exp * 10 + (s[i] - '0');
+        }
+        a->dp += expneg ? -exp : exp;
+    }
+    jsmn_decimal_trim(a);
+}
+
+/**
+ * Multiplies the decimal by 2^k, with k at most 60.
+ */
+static void jsmn_decimal_lshift(jsmn_Decimal *a, int k)
+{
+    uint64_t n = 0;
+    int delta = 0;
+    int r, w;
+
+    // The carry out of the first digit gives the number of new digits
+    for (r = a->nd - 1; r >= 0; r--) {
+        n = (n + ((uint64_t)a->d[r] << k)) / 10;
+    }
+    for (; n > 0; n /= 10) {
+        delta++;
+    }
+    w = a->nd + delta;
+    for (r = a->nd - 1; r >= 0; r--) {
+        n += (uint64_t)a->d[r] << k;
+        w--;
+        if (w < JSMN_DECIMAL_DIGITS) {
+            a->d[w] = (unsigned char)(n % 10);
+        } else if (n % 10 != 0) {
+            a->trunc = 1;
+        }
+        n /= 10;
+    }
+    while (n > 0) {
+        a->d[--w] = (unsigned char)(n % 10);
+        n /= 10;
+    }
+    a->nd += delta;
+    if (a->nd > JSMN_DECIMAL_DIGITS) a->nd = JSMN_DECIMAL_DIGITS;
+    a->dp += delta;
+    jsmn_decimal_trim(a);
+}
+
+/**
+ * Divides the decimal by 2^k, with k at most 60.
+ */
+static void jsmn_decimal_rshift(jsmn_Decimal *a, int k)
+{
+    uint64_t n = 0;
+    uint64_t mask = ((uint64_t)1 << k) - 1;
+    int r = 0, w = 0;
+
+    // Pick up enough leading digits to cover the first shift
+    for (; n >> k == 0; r++) {
+        if (r >= a->nd) {
+            if (n == 0) {
+                a->nd = 0;
+                return;
+            }
+            while (n >> k == 0) {
+                n *= 10;
+                r++;
+            }
+            break;
+        }
+        n = n * 10 + a->d[r];
+    }
+    a->dp -= r - 1;
+    for (; r < a->nd; r++) {
+        uint64_t c = a->d[r];
+        a->d[w++] = (unsigned char)(n >> k);
+        n = ((n & mask) * 10) + c;
+    }
+    while (n > 0) {
+        uint64_t dig = n >> k;
+        n = (n & mask) * 10;
+        if (w < JSMN_DECIMAL_DIGITS) {
+            a->d[w++] = (unsigned char)dig;
+        } else if (dig > 0) {
+            a->trunc = 1;
+        }
+    }
+    a->nd = w;
+    jsmn_decimal_trim(a);
 }
 
-int jsmn_parse(jsmn_Parser *parser, const char *js, size_t len) {
-    jsmn_Factory *factory = (jsmn_Factory *)parser;
-    jsmn_Token *token;
-    jsmn_Token *tokens = factory->toks;
-    int count = factory->toknext;
-    int r;
+/**
+ * Multiplies (k > 0) or divides (k < 0) the decimal by 2^|k|.
+ */
+static void jsmn_decimal_shift(jsmn_Decimal *a, int k)
+{
+    if (a->nd == 0) return;
+    for (; k > 60; k -= 60) {
+        jsmn_decimal_lshift(a, 60);
+    }
+    if (k > 0) jsmn_decimal_lshift(a, k);
+    for (; k < -60; k += 60) {
+        jsmn_decimal_rshift(a, 60);
+    }
+    if (k < 0) jsmn_decimal_rshift(a, -k);
+}
+
+/**
+ * Checks whether the decimal has to be rounded up when cutting it after 'nd'
+ * digits, rounding half to even.
+ */
+static int jsmn_decimal_round_up(const jsmn_Decimal *a, int nd)
+{
+    if (nd < 0 || nd >= a->nd) return 0;
+    if (a->d[nd] == 5 && nd + 1 == a->nd) {
+        if (a->trunc) return 1;
+        return nd > 0 && a->d[nd - 1] % 2 != 0;
+    }
+    return a->d[nd] >= 5;
+}
+
+/**
+ * Returns the integer part of the decimal, rounded to the nearest.
+ */
+static uint64_t jsmn_decimal_integer(const jsmn_Decimal *a)
+{
+    uint64_t n = 0;
     int i;
 
-    if (parser->js == NULL) {
-        parser->js = js;
-    } else if (parser->js != js) {
-        // JSON string has been realocated, re-calculate old data pointers
-        int offset = js - parser->js;
-        for (i = 0; i < count; i++) {
-            if (tokens[i].data != NULL) {
-                tokens[i].data += offset;
-            }
+    for (i = 0; i < a->dp && i < a->nd; i++) {
+        n = n * 10 + a->d[i];
+    }
+    for (; i < a->dp; i++) {
+        n *= 10;
+    }
+    if (jsmn_decimal_round_up(a, a->dp)) n++;
+    return n;
+}
+
+/**
+ * Converts the decimal to the bits of a positive double, rounding to the
+ * nearest. Returns -1, if it is too large and the bits are infinity.
+ */
+static int jsmn_decimal_to_double(jsmn_Decimal *a, uint64_t *bits)
+{
+    // Powers of two by which the decimal point moves by up to 8 digits
+    static const int powtab[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    uint64_t mant;
+    int exp = 0;
+    int n;
+
+    if (a->nd == 0) {
+        *bits = 0;
+        return 0;
+    }
+    if (a->dp > 310) goto overflow;
+    if (a->dp < -330) {
+        *bits = 0;
+        return 0;
+    }
+    // Scale to a value in [0.5, 1)
+    while (a->dp > 0) {
+        n = a->dp >= 9 ? 27 : powtab[a->dp];
+        jsmn_decimal_shift(a, -n);
+        exp += n;
+    }
+    while (a->dp < 0 || (a->dp == 0 && a->d[0] < 5)) {
+        n = -a->dp >= 9 ? 27 : powtab[-a->dp];
+        jsmn_decimal_shift(a, n);
+        exp -= n;
+    }
+    // The value is in [0.5, 1) * 2^exp, i.e. in [1, 2) * 2^(exp - 1)
+    exp--;
+    if (exp < -1022) {
+        // Subnormal
+        jsmn_decimal_shift(a, -(-1022 - exp));
+        exp = -1022;
+    }
+    if (exp + 1023 >= 0x7ff) goto overflow;
+    jsmn_decimal_shift(a, 53);
+    mant = jsmn_decimal_integer(a);
+    if (mant == (uint64_t)2 << 52) {
+        // Rounding up carried into the next power of two
+        mant >>= 1;
+        exp++;
+        if (exp + 1023 >= 0x7ff) goto overflow;
+    }
+    if (!(mant & ((uint64_t)1 << 52))) {
+        exp = -1023;
+    }
+    *bits = (uint64_t)(exp + 1023) << 52 | (mant & 0xfffffffffffff);
+    return 0;
+
+overflow:
+    *bits = (uint64_t)0x7ff << 52;
+    return -1;
+}
+
+/**
+ * Parses the decimal integer of 'len' bytes at 's'. Returns 0,
+ * JSMN_ERROR_INVAL if it is no integer according to the JSON grammar or
+ * JSMN_ERROR_RANGE if its magnitude does not fit into 64 bits.
+ */
+static int jsmn_scan_integer(const char *s, int len, int *neg, uint64_t *value)
+{
+    uint64_t n = 0;
+    int range = 0;
+    int i = 0;
+
+    *neg = 0;
+    if (i < len && s[i] == '-') {
+        *neg = 1;
+        i++;
+    }
+    if (i >= len || s[i] < '0' || s[i] > '9') {
+        return JSMN_ERROR_INVAL;
+    }
+    if (s[i] == '0' && i + 1 < len) {
+        // Leading zero, fraction or exponent
+        return JSMN_ERROR_INVAL;
+    }
+    for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+        unsigned int d = s[i] - '0';
+        if (n > (UINT64_MAX - d) / 10) {
+            range = 1;
         }
-        parser->js = js;
+        n = n * 10 + d;
     }
-    // Parse JSON string
-    for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
-        char c;
-        jsmntype_t type;
+    if (i < len) {
+        return JSMN_ERROR_INVAL;
+    }
+    *value = n;
+    return range ? JSMN_ERROR_RANGE : 0;
+}
 
-        c = js[parser->pos];
-        switch (c) {
-            case '{': case '[':
-                count++;
-                if (tokens == NULL) {
-                    break;
-                }
-                token = jsmn_alloc_token(factory, 1);
-                if (token == NULL)
-                    return JSMN_ERROR_NOMEM;
-                if (factory->toksuper != -1) {
-                    tokens[factory->toksuper].size++;
-                    token->parent = factory->toksuper;
-                }
-                token->type = (c == '{' ? JSMN_OBJECT : JSMN_ARRAY);
-                token->data = js + parser->pos;
-                factory->toksuper = factory->toknext - 1;
+int jsmn_get_int64(const char *js, const jsmn_Token *t, int64_t *value)
+{
+    uint64_t n;
+    int neg, r;
+
+    if (t->type != JSMN_PRIMITIVE) {
+        return JSMN_ERROR_INVAL;
+    }
+    r = jsmn_scan_integer(jsmn_token_data(js, t), t->length, &neg, &n);
+    if (r < 0) return r;
+    if (n > (uint64_t)INT64_MAX + neg) {
+        return JSMN_ERROR_RANGE;
+    }
+    // Negate unsigned, as -INT64_MIN does not fit
+    *value = neg ? (int64_t)(0 - n) : (int64_t)n;
+    return 0;
+}
+
+int jsmn_get_uint64(const char *js, const jsmn_Token *t, uint64_t *value)
+{
+    uint64_t n;
+    int neg, r;
+
+    if (t->type != JSMN_PRIMITIVE) {
+        return JSMN_ERROR_INVAL;
+    }
+    r = jsmn_scan_integer(jsmn_token_data(js, t), t->length, &neg, &n);
+    if (r < 0) return r;
+    if (neg && n != 0) {
+        return JSMN_ERROR_RANGE;
+    }
+    *value = n;
+    return 0;
+}
+
+int jsmn_get_double(const char *js, const jsmn_Token *t, double *value)
+{
+    const char *s;
+    jsmn_Number num;
+    uint64_t bits, up;
+    int r = 0;
+
+    if (t->type != JSMN_PRIMITIVE) {
+        return JSMN_ERROR_INVAL;
+    }
+    s = jsmn_token_data(js, t);
+    if (jsmn_scan_number(s, t->length, &num) < 0) {
+        return JSMN_ERROR_INVAL;
+    }
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Both operands are exact, so is the correctly rounded result
+    if (!num.trunc && num.man >> 53 == 0 &&
+            num.exp10 >= -22 && num.exp10 <= 22) {
+        double d = (double)num.man;
+        if (num.exp10 < 0) {
+            d /= jsmn_pow10_exact[-num.exp10];
+        } else {
+            d *= jsmn_pow10_exact[num.exp10];
+        }
+        *value = num.neg ? -d : d;
+        return 0;
+    }
+#endif
+    // With dropped digits the value is between 'man' and 'man + 1'
+    if (jsmn_eisel_lemire(num.man, num.exp10, &bits) < 0 || (num.trunc &&
+            (jsmn_eisel_lemire(num.man + 1, num.exp10, &up) < 0 ||
+            up != bits))) {
+        jsmn_Decimal dec;
+        jsmn_decimal_init(&dec, s, t->length);
+        if (jsmn_decimal_to_double(&dec, &bits) < 0) {
+            r = JSMN_ERROR_RANGE;
+        }
+    }
+    if (num.neg) bits |= (uint64_t)1 << 63;
+    memcpy(value, &bits, sizeof(*value));
+    return r;
+}
+
+/**
+ * Checks the array token before its elements are converted.
+ */
+static int jsmn_check_array(const jsmn_Token *toks, int array, size_t len)
+{
+    if (toks[array].type != JSMN_ARRAY) {
+        return JSMN_ERROR_INVAL;
+    }
+    if ((size_t)toks[array].size > len) {
+        return JSMN_ERROR_NOMEM;
+    }
+    return 0;
+}
+
+int jsmn_get_int64_array(const char *js, const jsmn_Token *toks, int array,
+        int64_t *values, size_t len)
+{
+    int i, n = 0;
+    int r = jsmn_check_array(toks, array, len);
+
+    if (r < 0) return r;
+    for (i = array + 1; i < toks[array].next; i = toks[i].next) {
+        r = jsmn_get_int64(js, &toks[i], &values[n++]);
+        if (r < 0) return r;
+    }
+    return n;
+}
+
+int jsmn_get_uint64_array(const char *js, const jsmn_Token *toks, int array,
+        uint64_t *values, size_t len)
+{
+    int i, n = 0;
+    int r = jsmn_check_array(toks, array, len);
+
+    if (r < 0) return r;
+    for (i = array + 1; i < toks[array].next; i = toks[i].next) {
+        r = jsmn_get_uint64(js, &toks[i], &values[n++]);
+        if (r < 0) return r;
+    }
+    return n;
+}
+
+int jsmn_get_double_array(const char *js, const jsmn_Token *toks, int array,
+        double *values, size_t len)
+{
+    int i, n = 0;
+    int r = jsmn_check_array(toks, array, len);
+
+    if (r < 0) return r;
+    for (i = array + 1; i < toks[array].next; i = toks[i].next) {
+        r = jsmn_get_double(js, &toks[i], &values[n++]);
+        if (r < 0) return r;
+    }
+    return n;
+}
+
+/**
+ * Decodes the four hex digits at 's', returns -1 if they are no hex digits.
+ */
+static long jsmn_hex4(const char *s)
+{
+    long v = 0;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        char c = s[i];
+        if (c >= '0' && c <= '9') {
+            v = v * 16 + (c - '0');
+        } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+            v = v * 16 + ((c | 0x20) - 'a' + 10);
+        } else {
+            return -1;
+        }
+    }
+    return v;
+}
+
+/**
+ * Writes the code point 'c' as UTF-8 to 'out', unless it is NULL. Returns the
+ * number of bytes.
+ */
+static int jsmn_put_utf8(char *out, long c)
+{
+    if (c < 0x80) {
+        if (out != NULL) out[0] = (char)c;
+        return 1;
+    }
+    if (c < 0x800) {
+        if (out != NULL) {
+            out[0] = (char)(0xc0 | (c >> 6));
+            out[1] = (char)(0x80 | (c & 0x3f));
+        }
+        return 2;
+    }
+    if (c < 0x10000) {
+        if (out != NULL) {
+            out[0] = (char)(0xe0 | (c >> 12));
+            out[1] = (char)(0x80 | ((c >> 6) & 0x3f));
+            out[2] = (char)(0x80 | (c & 0x3f));
+        }
+        return 3;
+    }
+    if (out != NULL) {
+        out[0] = (char)(0xf0 | (c >> 18));
+        out[1] = (char)(0x80 | ((c >> 12) & 0x3f));
+        out[2] = (char)(0x80 | ((c >> 6) & 0x3f));
+        out[3] = (char)(0x80 | (c & 0x3f));
+    }
+    return 4;
+}
+
+/**
+ * Decodes the escape sequences of the 'len' bytes at 's' into 'out' or, if
+ * 'out' is NULL, only counts the decoded bytes. As no escape sequence is
+ * shorter than its decoded bytes, 'out' may be 's' itself.
+ */
+static int jsmn_unescape(const char *s, int len, char *out)
+{
+    int i = 0;
+    int n = 0;
+
+    while (i < len) {
+        // Runs without escape sequences are found and copied by the
+        // vectorised memchr and memmove of the C library.
+        const char *p = memchr(s + i, '\\', len - i);
+        int run = (p != NULL ? p - s : len) - i;
+        long c;
+
+        if (out != NULL && run > 0 && out + n != s + i) {
+            memmove(out + n, s + i, run);
+        }
+        n += run;
+        i += run;
+        if (i >= len) {
+            break;
+        }
+        if (i + 1 >= len) {
+            return JSMN_ERROR_INVAL;
+        }
+        switch (s[i + 1]) {
+            case '\"': case '/': case '\\':
+                c = s[i + 1];
                 break;
-            case '}': case ']':
-                if (tokens == NULL)
-                    break;
-                type = (c == '}' ? JSMN_OBJECT : JSMN_ARRAY);
-                if (factory->toknext < 1) {
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u':
+                if (i + 6 > len || (c = jsmn_hex4(s + i + 2)) < 0) {
                     return JSMN_ERROR_INVAL;
                 }
-                token = &tokens[factory->toknext - 1];
-                for (;;) {
-                    if (token->data != NULL && token->length == -1) {
-                        if (token->type != type) {
-                            return JSMN_ERROR_INVAL;
-                        }
-                        token->length = parser->pos - (token->data - js) + 1;
-                        factory->toksuper = token->parent;
-                        break;
-                    }
-                    if (token->parent == -1) {
-                        if(token->type != type || factory->toksuper == -1) {
-                            return JSMN_ERROR_INVAL;
-                        }
-                        break;
+                i += 6;
+                if (c >= 0xd800 && c < 0xdc00 && i + 6 <= len &&
+                        s[i] == '\\' && s[i + 1] == 'u') {
+                    // Surrogate pair
+                    long lo = jsmn_hex4(s + i + 2);
+                    if (lo >= 0xdc00 && lo < 0xe000) {
+                        c = 0x10000 + ((c - 0xd800) << 10) + (lo - 0xdc00);
+                        i += 6;
                     }
-                    token = &tokens[token->parent];
-                }
-                break;
-            case '\"':
-                r = jsmn_parse_string(parser, js, len);
-                if (r < 0) return r;
-                count++;
-                if (factory->toksuper != -1 && tokens != NULL)
-                    tokens[factory->toksuper].size++;
-                break;
-            case '\t' : case '\r' : case '\n' : case ' ':
-                break;
-            case ':':
-                factory->toksuper = factory->toknext - 1;
-                break;
-            case ',':
-                if (tokens != NULL && factory->toksuper != -1 &&
-                        tokens[factory->toksuper].type != JSMN_ARRAY &&
-                        tokens[factory->toksuper].type != JSMN_OBJECT) {
-                    factory->toksuper = tokens[factory->toksuper].parent;
                 }
-                break;
-            // In strict mode primitives are: numbers and booleans
-            case '-': case '0': case '1' : case '2': case '3' : case '4':
-            case '5': case '6': case '7' : case '8': case '9':
-            case 't': case 'f': case 'n' :
-                // And they must not be keys of the object
-                if (tokens != NULL && factory->toksuper != -1) {
-                    jsmn_Token *t = &tokens[factory->toksuper];
-                    if (t->type == JSMN_OBJECT ||
-                            (t->type == JSMN_STRING && t->size != 0)) {
-                        return JSMN_ERROR_INVAL;
-                    }
+                if (c >= 0xd800 && c < 0xe000) {
+                    // Lone surrogates are replaced by U+FFFD
+                    c = 0xfffd;
                 }
-                r = jsmn_parse_primitive(parser, js, len);
-                if (r < 0) return r;
-                count++;
-                if (factory->toksuper != -1 && tokens != NULL)
-                    tokens[factory->toksuper].size++;
-                break;
-
-            // Unexpected char in strict mode
+                n += jsmn_put_utf8(out != NULL ? out + n : NULL, c);
+                continue;
             default:
                 return JSMN_ERROR_INVAL;
         }
+        if (out != NULL) out[n] = (char)c;
+        n++;
+        i += 2;
     }
+    return n;
+}
 
-    if (tokens != NULL) {
-        for (i = factory->toknext - 1; i >= 0; i--) {
-            // Unmatched opened object or array
-            if (tokens[i].data != NULL && tokens[i].length == -1) {
-                return JSMN_ERROR_PART;
-            }
-        }
+const char *jsmn_string_view(const char *js, const jsmn_Token *t)
+{
+    if ((t->type != JSMN_STRING && t->type != JSMN_LABEL) ||
+            (t->flags & JSMN_FLAG_ESCAPED)) {
+        return NULL;
     }
+    return jsmn_token_data(js, t);
+}
 
-    return count;
+int jsmn_string_length(const char *js, const jsmn_Token *t)
+{
+    if (t->type != JSMN_STRING && t->type != JSMN_LABEL) {
+        return JSMN_ERROR_INVAL;
+    }
+    if (!(t->flags & JSMN_FLAG_ESCAPED)) {
+        return t->length;
+    }
+    return jsmn_unescape(jsmn_token_data(js, t), t->length, NULL);
+}
+
+int jsmn_string_decode(const char *js, const jsmn_Token *t, char *buf,
+        size_t len)
+{
+    const char *s;
+    int n;
+
+    if (t->type != JSMN_STRING && t->type != JSMN_LABEL) {
+        return JSMN_ERROR_INVAL;
+    }
+    s = jsmn_token_data(js, t);
+    if (!(t->flags & JSMN_FLAG_ESCAPED)) {
+        if ((size_t)t->length > len) {
+            return JSMN_ERROR_NOMEM;
+        }
+        if (buf != s) {
+            memmove(buf, s, t->length);
+        }
+        return t->length;
+    }
+    if ((size_t)t->length > len) {
+        // The decoded string might still fit
+        n = jsmn_unescape(s, t->length, NULL);
+        if (n < 0) return n;
+        if ((size_t)n > len) {
+            return JSMN_ERROR_NOMEM;
+        }
+    }
+    return jsmn_unescape(s, t->length, buf);
 }
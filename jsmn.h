@@ -14,6 +14,39 @@
  * of every JSON packet or allocating temporary objects to store parsed JSON
  * fields often is an overkill.
  *
+ * Build Options
+ * -------------
+ *
+ * - JSMN_STRICT: Check the JSON grammar: reject primitives which are neither
+ *   a number nor one of the literals true, false and null, strings which are
+ *   not valid UTF-8 and misplaced keys, colons and commas. Without it the
+ *   parser is permissive and e.g. takes any unquoted text for a primitive,
+ *   also as a key.
+ * - JSMN_PARENT_LINKS: Store the index of the superior token in 'parent' of
+ *   every token. It has to be the same for the library and its users.
+ * - JSMN_NO_SIMD: Do not use the SSE2/AVX2 structural indexer on x86, every
+ *   byte is looked at by the plain parser loops.
+ * - JSMN_MAX_DEPTH: Number of open objects and arrays a parser or factory
+ *   keeps on its stack (default 32), deeper ones are linked through their
+ *   tokens. It has to be the same for the library and its users, as it
+ *   defines the size of jsmn_Factory (4 bytes per level).
+ * - JSMN_COMPACT_TOKENS: Use tokens which only store the offset of their data
+ *   instead of a pointer and pack their type, flags and size into one word,
+ *   see 'jsmn_token_data'. They take 16 bytes, 20 bytes with
+ *   JSMN_PARENT_LINKS. It has to be the same for the library and its users.
+ * - JSMN_LOOKUP_OBJECTS: Number of objects a jsmn_Lookup keeps a hash index
+ *   for (default 8). It has to be the same for the library and its users.
+ * - JSMN_MATCH_SEGMENTS: Number of path segments of all paths of a
+ *   jsmn_Matcher (default 128). It has to be the same for the library and its
+ *   users.
+ * - JSMN_FREESTANDING: Leave out everything which needs more of the C library
+ *   than a few string functions, like the stdio and file descriptor sinks.
+ *   It is the default, if the compiler does not target a hosted environment.
+ * - JSMN_MMAP: Provide 'jsmn_parse_file' and 'jsmn_parse_fd', which map a
+ *   file with POSIX mmap and need the C library, on Unix like systems.
+ * - JSMN_THREADS: Provide 'jsmn_parse_parallel' and 'jsmn_parse_split',
+ *   which need POSIX threads and the C library.
+ *
  * Other Info
  * ----------
  *
@@ -48,6 +81,15 @@
 #define _UTIL_JSMN_H_
 
 #include <stddef.h>
+#include <stdint.h>
+
+// Hosted builds use stdio and, on Unix like systems, POSIX I/O
+#if __STDC_HOSTED__ && !defined(JSMN_FREESTANDING)
+#define JSMN_HOSTED 1
+#if defined(__unix__) || defined(__APPLE__)
+#define JSMN_POSIX 1
+#endif
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -78,20 +120,149 @@ enum jsmnerr {
     /** The string is not a full JSON packet, more bytes expected */
     JSMN_ERROR_PART = -3,
     /** Something went wrong while composing the JSON tokens */
-    JSMN_ERROR_FACTORY = -4
+    JSMN_ERROR_FACTORY = -4,
+    /** Objects and arrays are nested too deeply, no longer returned */
+    JSMN_ERROR_DEPTH = -5,
+    /** The number does not fit into the requested type */
+    JSMN_ERROR_RANGE = -6,
+    /** The file cannot be opened or mapped or is too large */
+    JSMN_ERROR_IO = -7
 };
 
+/**
+ * @brief JSON Token Flags
+ */
+enum jsmnflag {
+    /**
+     * The string or label contains escape sequences. Without this flag
+     * 'data' and 'length' can be used as they are, no decoding is needed.
+     */
+    JSMN_FLAG_ESCAPED = 0x01,
+    /** Kind of a primitive, see 'jsmn_primitive_kind' */
+    JSMN_FLAG_KIND = 0x0e,
+    /**
+     * The string or label is plain text, which is escaped when dumped. The
+     * builders set it, strings of the parser are JSON already and copied as
+     * they are. Clear it for text known not to need escaping.
+     */
+    JSMN_FLAG_RAW = 0x10
+};
+
+/**
+ * @brief Kind of a Primitive
+ *
+ * The parser classifies every primitive while scanning it. A number with a
+ * fraction or an exponent is a float. JSMN_KIND_INVALID is only found in
+ * non-strict builds, as the strict parser rejects malformed primitives.
+ */
+typedef enum {
+    JSMN_KIND_INVALID = 0,
+    JSMN_KIND_INTEGER = 1,
+    JSMN_KIND_FLOAT = 2,
+    JSMN_KIND_TRUE = 3,
+    JSMN_KIND_FALSE = 4,
+    JSMN_KIND_NULL = 5
+} jsmnkind_t;
+
 /**
  * @brief JSON Token
+ *
+ * The subtree of a token consists of the token and all its descendants, the
+ * one of a label includes its value. As 'next' is the index after the
+ * subtree, values can be skipped or members iterated without recursion. The
+ * 'next' of an object or array is only final once it has been closed.
+ *
+ * With JSMN_COMPACT_TOKENS the token has no 'data' pointer, its type and flags
+ * are packed together with its size, which is therefore limited to
+ * JSMN_COMPACT_SIZE_MAX. Use 'jsmn_token_data' to get the data of a token
+ * with either layout. A compact token takes 16 bytes, with JSMN_PARENT_LINKS
+ * 20 bytes, as 'parent' and 'next' both need the full range of indices.
+ *
+ * Only with JSMN_PARENT_LINKS the token has a 'parent', the index of the
+ * object or array it is an element of, the label it is the value of or -1.
  */
+#ifdef JSMN_COMPACT_TOKENS
+#define JSMN_COMPACT_SIZE_MAX 0xffffff
+typedef struct {
+    /** Offset of data in the parsed JSON string or stream */
+    unsigned int start;
+    int length;
+    /** JSMN Type (object, array, string etc.) */
+    unsigned int type : 3;
+    /** JSMN Flags (JSMN_FLAG_*) */
+    unsigned int flags : 5;
+    unsigned int size : 24;
+#ifdef JSMN_PARENT_LINKS
+    int parent;
+#endif
+    /** Index of the token following the subtree of this token */
+    int next;
+} jsmn_Token;
+#else
 typedef struct {
     /** JSMN Type (object, array, string etc.) */
     jsmntype_t type;
+    /** JSMN Flags (JSMN_FLAG_*) */
+    unsigned int flags;
     const char *data;
     int length;
     int size;
+#ifdef JSMN_PARENT_LINKS
     int parent;
+#endif
+    /** Offset of data in the parsed JSON string or stream */
+    unsigned int start;
+    /** Index of the token following the subtree of this token */
+    int next;
 } jsmn_Token;
+#endif
+
+/**
+ * @brief Data of a Token
+ *
+ * Returns the data of token 't', where 'js' is the JSON string the token has
+ * been parsed from or the 'base' of the factory which built it.
+ */
+#ifdef JSMN_COMPACT_TOKENS
+#define jsmn_token_data(js, t) ((const char *)(js) + (t)->start)
+#else
+#define jsmn_token_data(js, t) ((void)(js), (t)->data)
+#endif
+
+/**
+ * @brief Kind of a Primitive Token
+ *
+ * Returns the jsmnkind_t recorded in the flags of the primitive 't'.
+ */
+#define jsmn_primitive_kind(t) \
+        ((jsmnkind_t)(((t)->flags & JSMN_FLAG_KIND) >> 1))
+
+/**
+ * @brief Token Allocator
+ *
+ * Lets a factory grow its token array instead of running out of tokens. The
+ * array is owned by the allocator and freed by 'jsmn_factory_free'.
+ */
+typedef struct {
+    /** Resizes 'toks' (NULL at first) to 'len' tokens like 'realloc' */
+    jsmn_Token *(*grow)(void *ctx, jsmn_Token *toks, size_t len);
+    /** Frees 'toks' */
+    void (*free)(void *ctx, jsmn_Token *toks);
+    /** User context passed to the callbacks */
+    void *ctx;
+} jsmn_Allocator;
+
+/**
+ * @brief Depth of the Stack of Open Objects and Arrays
+ *
+ * Number of open objects and arrays a parser or factory keeps on its stack.
+ * Deeper ones are linked through the 'length' of their tokens until they are
+ * closed, so the nesting depth is not limited. Paths of a matcher have at
+ * most this many segments.
+ */
+#ifndef JSMN_MAX_DEPTH
+#define JSMN_MAX_DEPTH 32
+#endif
 
 /**
  * @brief JSON Factory
@@ -99,6 +270,20 @@ typedef struct {
  * The factory is used to compose the JSON tokens either from a string by
  * parsing or by using functions like 'jsmn_start_object', 'jsmn_append_string'
  * and so on.
+ *
+ * Without an allocator the token array is fixed and the factory fails when it
+ * is full. With an allocator it is grown geometrically, 'toks' may therefore
+ * change with every token added.
+ *
+ * With JSMN_COMPACT_TOKENS the names and values passed to the builders are
+ * stored as offsets relative to 'base', which has to be set by the caller.
+ * They have to lie within 4 GiB after it, others are copied into the
+ * character storage if the factory has one.
+ *
+ * Numbers appended by 'jsmn_append_int64' and the like are formatted into the
+ * character storage of the factory, see 'jsmn_factory_storage'. Used as an
+ * arena, see 'jsmn_factory_arena', it also keeps copies of all names and
+ * strings, so they do not have to outlive the builder calls.
  */
 typedef struct {
     jsmn_Token *toks; // array of tokens
@@ -106,19 +291,143 @@ typedef struct {
     unsigned int toknext; // next token to allocate
     int toksuper; // superior token node, e.g parent object or array
     int toklabel; // Label
+    unsigned int depth; // number of open objects and arrays
+    int stack[JSMN_MAX_DEPTH]; // token indices of the open objects and arrays
+    int open; // innermost open object or array beyond the stack
+    const jsmn_Allocator *alloc; // allocator of toks or NULL
+    char *chars; // character storage of values formatted by the builders
+    size_t charslen; // size of chars
+    size_t charnext; // next character to use
+    int arena; // names and values are copied into chars
+#ifdef JSMN_COMPACT_TOKENS
+    const char *base; // names and values of the builders are relative to it
+#endif
 } jsmn_Factory;
 
 /**
  * @brief JSON Parser
  *
- * Contains a factory and the current position in the JSON string.
+ * Contains a factory, which keeps the stack of the currently open objects
+ * and arrays, and the current position in the JSON string.
  */
 typedef struct {
     jsmn_Factory factory;
     const char *js; // JSON string to be parsed
     unsigned int pos; // offset in the JSON string
+    unsigned int base; // stream offset of the JSON string
+    unsigned int expect; // what the strict parser accepts next
+    jsmntype_t tokpart; // string or primitive cut off by the end of the data
+    unsigned int tokstart; // offset of the cut off token in the JSON string
+    unsigned int tokflags; // flags of the cut off token found so far
 } jsmn_Parser;
 
+/**
+ * @brief Record of a Batch
+ *
+ * A document found by 'jsmn_parse_records'. A failed record has no tokens,
+ * it spans the rest of its line up to the LF or CRLF line break.
+ */
+typedef struct {
+    int error; // 0 or the error the record failed with
+    int token; // index of the first token of the record
+    int count; // number of tokens of the record
+    unsigned int start; // offset of the record in the JSON string
+    unsigned int length; // number of bytes of the record
+} jsmn_Record;
+
+#ifdef JSMN_MMAP
+/**
+ * @brief Mapped JSON File
+ *
+ * The file parsed by 'jsmn_parse_file', its tokens point into the mapping.
+ */
+typedef struct {
+    jsmn_Parser parser; // parser of the file and its tokens
+    const char *js; // data of the file, mapped read-only
+    size_t len; // length of the file
+} jsmn_File;
+#endif
+
+/**
+ * @brief Number of Objects Indexed by a Lookup
+ */
+#ifndef JSMN_LOOKUP_OBJECTS
+#define JSMN_LOOKUP_OBJECTS 8
+#endif
+
+/**
+ * @brief Minimal Size of an Object to be Indexed by a Lookup
+ *
+ * Smaller objects are searched linearly.
+ */
+#define JSMN_LOOKUP_MIN 8
+
+/**
+ * @brief Member Lookup
+ *
+ * Caches hash indices of the objects of one document for 'jsmn_lookup'. The
+ * slots of the hash tables are provided by the caller, an object needs about
+ * twice as many slots as it has members. When the slots run out or
+ * JSMN_LOOKUP_OBJECTS objects are indexed, further objects are searched
+ * linearly.
+ */
+typedef struct {
+    int *slots; // token indices of the labels, 0 for an empty slot
+    size_t slotslen; // length of the slots array
+    size_t slotsnext; // first slot not used by a hash table
+    unsigned int count; // number of indexed objects
+    struct {
+        int object; // token index of the object
+        unsigned int offset; // first slot of the hash table
+        unsigned int mask; // number of slots of the hash table minus one
+    } tables[JSMN_LOOKUP_OBJECTS];
+} jsmn_Lookup;
+
+/**
+ * @brief Maximum Number of Paths of a Matcher
+ */
+#define JSMN_MATCH_PATHS 32
+
+#ifndef JSMN_MATCH_SEGMENTS
+#define JSMN_MATCH_SEGMENTS 128
+#endif
+
+/**
+ * @brief Path Segment
+ *
+ * A member name or an array index of a path, or a wildcard ('*') matching
+ * every member and element.
+ */
+typedef struct {
+    const char *key; // member name in the path (still escaped), NULL for '*'
+    int length; // length of the member name in the path
+    int index; // array index or -1
+    int escaped; // the member name contains '~0' or '~1'
+} jsmn_Segment;
+
+/**
+ * @brief Path Matcher
+ *
+ * A set of paths compiled by 'jsmn_matcher_compile'.
+ */
+typedef struct {
+    unsigned int count; // number of paths
+    unsigned int segsnext; // first unused segment
+    struct {
+        unsigned int first; // first segment of the path
+        unsigned int length; // number of segments
+    } paths[JSMN_MATCH_PATHS];
+    jsmn_Segment segs[JSMN_MATCH_SEGMENTS];
+} jsmn_Matcher;
+
+/**
+ * @brief Match of a Path
+ */
+typedef struct {
+    int path; // index of the path passed to 'jsmn_matcher_compile'
+    int token; // index of the matching token
+} jsmn_Match;
+
 /**
  * @brief Write Handler
  * 
@@ -127,16 +436,66 @@ typedef struct {
  */
 typedef int (*jsmn_write_handle_t)(const char *data, size_t length);
 
+/**
+ * @brief Fragment of Output
+ */
+typedef struct {
+    const char *data;
+    size_t length;
+} jsmn_Fragment;
+
+/**
+ * @brief Sink of a Writer
+ *
+ * Writes one or two fragments in this order to the sink 'ctx' of the writer.
+ * Returns a negative error code on failure.
+ */
+typedef int (*jsmn_sink_handle_t)(void *ctx, const jsmn_Fragment *frags,
+        int count);
+
+/**
+ * @brief Buffered Writer
+ *
+ * Collects the output in a buffer and hands it to the sink in blocks of the
+ * size of the buffer. Larger data is passed through along with the buffer.
+ * Without a sink the output stays in the buffer, e.g. to build a string.
+ */
+typedef struct {
+    jsmn_sink_handle_t sink; // sink of full buffers or NULL
+    void *ctx; // context of the sink
+    char *buf; // buffer
+    size_t size; // size of the buffer
+    size_t len; // number of bytes in the buffer
+    int error; // first error, further output is dropped
+} jsmn_Writer;
+
 /**
  * @brief Initialise Factory
  */
 void jsmn_factory_init(jsmn_Factory *factory, jsmn_Token *toks, size_t len);
 
+/**
+ * @brief Initialise Factory with a Growing Token Array
+ */
+void jsmn_factory_init_alloc(jsmn_Factory *factory,
+        const jsmn_Allocator *alloc);
+
+/**
+ * @brief Free the Token Array of a Factory with an Allocator
+ */
+void jsmn_factory_free(jsmn_Factory *factory);
+
 /**
  * @brief Start a New JSON Object
  */
 int jsmn_start_object(jsmn_Factory *factory, const char *name);
 
+/**
+ * @brief Start a New JSON Object with a Name of the Given Length
+ */
+int jsmn_start_object_len(jsmn_Factory *factory, const char *name,
+        size_t namelen);
+
 /**
  * @brief End the Current JSON Object
  */
@@ -147,6 +506,12 @@ int jsmn_end_object(jsmn_Factory *factory);
  */
 int jsmn_start_array(jsmn_Factory *factory, const char *name);
 
+/**
+ * @brief Start a New JSON Array with a Name of the Given Length
+ */
+int jsmn_start_array_len(jsmn_Factory *factory, const char *name,
+        size_t namelen);
+
 /**
  * @brief End the Current JSON Array
  */
@@ -158,30 +523,507 @@ int jsmn_end_array(jsmn_Factory *factory);
 int jsmn_append_string(jsmn_Factory *factory, const char *name,
         const char *value);
 
+/**
+ * @brief Append a JSON String of the Given Length
+ *
+ * Like 'jsmn_append_string' without 'strlen', the name and value need not be
+ * terminated.
+ */
+int jsmn_append_string_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, const char *value, size_t len);
+
 /**
  * @brief Append a JSON Primitive
  */
 int jsmn_append_primitive(jsmn_Factory *factory, const char *name,
         const char *value);
 
+/**
+ * @brief Append a JSON Primitive of the Given Length
+ */
+int jsmn_append_primitive_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, const char *value, size_t len);
+
+/**
+ * @brief Set the Character Storage of a Factory
+ *
+ * Values formatted by the builders are kept in 'buf' until the tokens are
+ * dumped. With JSMN_COMPACT_TOKENS 'buf' becomes the 'base' if the factory
+ * has none yet. Names and values before the 'base', like string literals, are
+ * then copied into 'buf' as well, so it has to hold them too.
+ */
+void jsmn_factory_storage(jsmn_Factory *factory, char *buf, size_t len);
+
+/**
+ * @brief Use a Buffer as the String Arena of a Factory
+ *
+ * Like 'jsmn_factory_storage', but the builders also copy all names and
+ * values into 'buf', one after the other, and fail with JSMN_ERROR_NOMEM when
+ * it is full. With JSMN_COMPACT_TOKENS they are thereby always within reach of
+ * the 'base'.
+ */
+void jsmn_factory_arena(jsmn_Factory *factory, char *buf, size_t len);
+
+/**
+ * @brief Reset a Factory for the Next Document
+ *
+ * Drops all tokens and characters at once, keeping the token array, its
+ * allocator and the storage.
+ */
+void jsmn_factory_reset(jsmn_Factory *factory);
+
+/**
+ * @brief Append a JSON Integer
+ *
+ * The number is formatted into the character storage of the factory, the
+ * builders fail with JSMN_ERROR_NOMEM when it is full.
+ */
+int jsmn_append_int64(jsmn_Factory *factory, const char *name, int64_t value);
+
+/**
+ * @brief Append a JSON Integer with a Name of the Given Length
+ */
+int jsmn_append_int64_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, int64_t value);
+
+/**
+ * @brief Append an Unsigned JSON Integer
+ */
+int jsmn_append_uint64(jsmn_Factory *factory, const char *name,
+        uint64_t value);
+
+/**
+ * @brief Append an Unsigned JSON Integer with a Name of the Given Length
+ */
+int jsmn_append_uint64_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, uint64_t value);
+
+/**
+ * @brief Append a JSON Number from a Double
+ *
+ * The number is formatted as a float like "1.0" or "1e+100" with digits
+ * which read back to the same double, the fewest in almost all cases
+ * (Grisu2). Infinity and NaN have no JSON representation and fail with
+ * JSMN_ERROR_INVAL.
+ */
+int jsmn_append_double(jsmn_Factory *factory, const char *name, double value);
+
+/**
+ * @brief Append a JSON Number from a Double with a Name of the Given Length
+ */
+int jsmn_append_double_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, double value);
+
+/**
+ * @brief Append a JSON Boolean
+ */
+int jsmn_append_bool(jsmn_Factory *factory, const char *name, int value);
+
+/**
+ * @brief Append a JSON Boolean with a Name of the Given Length
+ */
+int jsmn_append_bool_len(jsmn_Factory *factory, const char *name,
+        size_t namelen, int value);
+
+/**
+ * @brief Append a JSON Null
+ */
+int jsmn_append_null(jsmn_Factory *factory, const char *name);
+
+/**
+ * @brief Append a JSON Null with a Name of the Given Length
+ */
+int jsmn_append_null_len(jsmn_Factory *factory, const char *name,
+        size_t namelen);
+
+#ifndef JSMN_COMPACT_TOKENS
 /**
  * @brief Dump JSMN Tokens as a JSON String.
+ *
+ * Strings and labels flagged JSMN_FLAG_RAW are escaped. The output is
+ * buffered and passed to 'cb' in blocks, if it returns a negative value the
+ * dump fails with JSMN_ERROR_IO. It is written by 'jsmn_serialize'. Compact
+ * tokens do not point to their data, use 'jsmn_dump_js' with them.
  */
 int jsmn_dump(jsmn_Token *t, jsmn_write_handle_t cb);
+#endif
+
+/**
+ * @brief Dump JSMN Tokens of a JSON String
+ *
+ * Like 'jsmn_dump' with either token layout. The JSON string 'js' is passed
+ * to 'jsmn_token_data', it is only used with JSMN_COMPACT_TOKENS.
+ */
+int jsmn_dump_js(const char *js, jsmn_Token *t, jsmn_write_handle_t cb);
+
+/**
+ * @brief Initialise Writer
+ */
+void jsmn_writer_init(jsmn_Writer *writer, char *buf, size_t size,
+        jsmn_sink_handle_t sink, void *ctx);
+
+/**
+ * @brief Write to a Writer
+ *
+ * Returns 0 or the first error of the writer: JSMN_ERROR_NOMEM if the
+ * buffer of a writer without sink is full or the error of the sink.
+ */
+int jsmn_writer_write(jsmn_Writer *writer, const char *data, size_t length);
+
+/**
+ * @brief Flush a Writer
+ *
+ * Hands the buffered output to the sink. Returns like 'jsmn_writer_write'.
+ */
+int jsmn_writer_flush(jsmn_Writer *writer);
+
+/**
+ * @brief Memory Sink
+ *
+ * Writes to the 'jsmn_Writer' passed as 'ctx', e.g. one without sink to
+ * collect the output in memory.
+ */
+int jsmn_sink_memory(void *ctx, const jsmn_Fragment *frags, int count);
+
+#ifdef JSMN_HOSTED
+/**
+ * @brief File Sink
+ *
+ * Writes to the 'FILE' passed as 'ctx'. Fails with JSMN_ERROR_IO.
+ */
+int jsmn_sink_file(void *ctx, const jsmn_Fragment *frags, int count);
+#endif
+
+#ifdef JSMN_POSIX
+/**
+ * @brief File Descriptor Sink
+ *
+ * Writes to the file descriptor pointed to by 'ctx' with 'writev', resuming
+ * after partial writes and signals. Fails with JSMN_ERROR_IO.
+ */
+int jsmn_sink_fd(void *ctx, const jsmn_Fragment *frags, int count);
+#endif
+
+/**
+ * @brief Dump JSMN Tokens as a JSON String to a Writer
+ *
+ * Like 'jsmn_dump' but batches the output in the writer, which is not
+ * flushed. Same as 'jsmn_serialize' without indentation.
+ */
+int jsmn_dump_writer(const char *js, jsmn_Token *t, jsmn_Writer *writer);
+
+/**
+ * @brief Serialise JSMN Tokens to a Writer
+ *
+ * Writes the value 't' in one pass over the tokens. The open objects and
+ * arrays are kept on a stack of JSMN_MAX_DEPTH entries, only values nested
+ * deeper are written by a recursive call, so the depth is not limited. With
+ * an 'indent' greater than 0 every member and element starts a new line
+ * indented by so many spaces per level, otherwise the output is compact.
+ * Returns the number of tokens, JSMN_ERROR_INVAL for a token of undefined
+ * type or the error of the writer.
+ */
+int jsmn_serialize(const char *js, jsmn_Token *t, jsmn_Writer *writer,
+        int indent);
 
 /**
  * @brief Initialise Parser
  */
 void jsmn_parser_init(jsmn_Parser *parser, jsmn_Token *toks, size_t len);
 
+/**
+ * @brief Initialise Parser with a Growing Token Array
+ *
+ * The token array is freed by 'jsmn_factory_free(&parser->factory)'.
+ */
+void jsmn_parser_init_alloc(jsmn_Parser *parser, const jsmn_Allocator *alloc);
+
 /**
  * @brief Parse a JSON String to JSMN Tokens
  * 
  * It parses a JSON data string into and array of tokens, each describing a
  * single part of the JSON data.
+ *
+ * Without a token array and an allocator it returns the number of tokens
+ * needed, e.g. to allocate exactly as many. This pass only finds the token
+ * boundaries and, in strict mode, rejects invalid primitives. The strings and
+ * the placement of the tokens are checked by the parse filling the tokens.
  */
 int jsmn_parse(jsmn_Parser *parser, const char *js, size_t len);
 
+/**
+ * @brief Parse the Next Chunk of a JSON Stream
+ *
+ * The JSON string 'js' holds 'len' bytes of the stream starting at the stream
+ * offset 'parser->base'. Bytes which have already been passed have to be
+ * passed again, unless they have been dropped by 'jsmn_stream_release'. Each
+ * call only looks at the bytes which have not been parsed yet.
+ *
+ * The 'start' of a token is its offset in the stream. Its 'data' points into
+ * the 'js' of the call which created it and is not updated when the buffer
+ * moves, use 'js + (start - parser->base)' instead.
+ */
+int jsmn_stream_parse(jsmn_Parser *parser, const char *js, size_t len);
+
+/**
+ * @brief Release the Tokens and Bytes of Completed Values
+ *
+ * Drops all tokens but the open objects and arrays and their labels, which
+ * are moved to the front of the token array (their 'data' is set to NULL).
+ * Returns the number of bytes which the caller has to drop from the front of
+ * its buffer before the next call to 'jsmn_stream_parse'.
+ */
+size_t jsmn_stream_release(jsmn_Parser *parser);
+
+/**
+ * @brief Parse a Batch of JSON Documents
+ *
+ * Parses newline delimited JSON (NDJSON) or documents concatenated on a line
+ * like '{}{}' into one token array, each value at the root is a record. The
+ * parse of a line which fails is rolled back and the line is stored as a
+ * failed record, the next line is parsed as usual. A record cut off by the
+ * end of the data fails with JSMN_ERROR_PART. Records do not span lines.
+ *
+ * The parser needs a token array or an allocator. Returns the number of
+ * records stored in 'records'. If the records of a line do not fit, the parse
+ * stops before that line, 'parser->pos' is where the next call continues.
+ * JSMN_ERROR_NOMEM is returned only if not even the first line fits.
+ */
+int jsmn_parse_records(jsmn_Parser *parser, const char *js, size_t len,
+        jsmn_Record *records, size_t recordslen);
+
+#ifdef JSMN_MMAP
+/**
+ * @brief Parse a JSON File
+ *
+ * Maps the file at 'path' read-only, advising the kernel to read ahead and to
+ * use huge pages where it can, and parses it without copying. The tokens are
+ * grown by 'alloc' and point into the mapping, which stays until
+ * 'jsmn_file_close'. Returns like 'jsmn_parse' or JSMN_ERROR_IO if the file
+ * cannot be opened or mapped, e.g. as it is a pipe, or if it is larger than
+ * UINT_MAX bytes, beyond the 32 bit offsets of the tokens.
+ */
+int jsmn_parse_file(jsmn_File *file, const char *path,
+        const jsmn_Allocator *alloc);
+
+/**
+ * @brief Parse a JSON File by its Descriptor
+ *
+ * Like 'jsmn_parse_file' for the file open as 'fd', which may be closed
+ * afterwards.
+ */
+int jsmn_parse_fd(jsmn_File *file, int fd, const jsmn_Allocator *alloc);
+
+/**
+ * @brief Release a JSON File
+ *
+ * Frees the tokens and unmaps the file, also after a failed parse.
+ */
+void jsmn_file_close(jsmn_File *file);
+#endif
+
+#ifdef JSMN_THREADS
+/**
+ * @brief Records Handler
+ *
+ * Called by 'jsmn_parse_parallel' with the tokens and records of each chunk,
+ * one chunk after the other in input order. They are only valid during the
+ * call. Returning a negative number stops the parse with it.
+ */
+typedef int (*jsmn_records_handle_t)(void *ctx, const char *js,
+        const jsmn_Token *toks, const jsmn_Record *records, int count);
+
+/**
+ * @brief Parse a Batch of JSON Documents with Several Threads
+ *
+ * Splits the data of 'len' bytes into chunks of whole lines, which are parsed
+ * like by 'jsmn_parse_records' by 'threads' threads including the calling
+ * one. Each chunk gets its own parser, whose tokens are grown by 'alloc',
+ * which is therefore called by several threads at the same time. A free
+ * thread takes the next chunk, so a chunk taking long only holds up the
+ * handler, while the other threads parse ahead.
+ *
+ * The 'start' of the tokens and records is the offset in 'js'. Returns the
+ * number of records, the error of the handler or JSMN_ERROR_NOMEM.
+ */
+int jsmn_parse_parallel(const char *js, size_t len, unsigned int threads,
+        const jsmn_Allocator *alloc, jsmn_records_handle_t cb, void *ctx);
+
+/**
+ * @brief Parse a JSON String with Several Threads
+ *
+ * Like 'jsmn_parse', but the data is split into one chunk per thread. Each
+ * thread guesses from the quotes before its chunk whether it starts within a
+ * string, moves the chunk to start after a comma and parses it on its own.
+ * The tokens of the chunks are then joined, adding the members and elements
+ * of the objects and arrays spanning several chunks. The result is the one of
+ * 'jsmn_parse', which is used instead if a guess turns out to be wrong, the
+ * data is invalid or too short to be split or the parser is not fresh.
+ */
+int jsmn_parse_split(jsmn_Parser *parser, const char *js, size_t len,
+        unsigned int threads);
+#endif
+
+/**
+ * @brief Initialise Lookup
+ *
+ * The lookup is bound to the tokens of one document, it has to be initialised
+ * again for the next one.
+ */
+void jsmn_lookup_init(jsmn_Lookup *lookup, int *slots, size_t len);
+
+/**
+ * @brief Find the Member of an Object by its Name
+ *
+ * Looks for the label 'key' of 'len' bytes in the object 'toks[object]',
+ * which has to be closed. The key is compared with the raw label data, i.e.
+ * without decoding escape sequences. If there are several members with the
+ * same name the first one is found.
+ *
+ * With a 'lookup' the object gets a hash index on first use, which makes all
+ * further lookups in it O(1). Without one ('lookup' is NULL) the members are
+ * searched linearly.
+ *
+ * Returns the index of the value token, 0 if there is no such member or
+ * JSMN_ERROR_INVAL if the token is not an object.
+ */
+int jsmn_lookup(jsmn_Lookup *lookup, const char *js, const jsmn_Token *toks,
+        int object, const char *key, size_t len);
+
+/**
+ * @brief Compile Paths into a Matcher
+ *
+ * The paths are JSON Pointers (RFC 6901) like "/meta/host", where a segment
+ * '*' matches every member of an object and every element of an array. A
+ * segment of digits matches the array element with that index as well as the
+ * object member with that name. The empty path matches the root. The paths
+ * are referenced by the matcher and have to be kept.
+ *
+ * Returns 0 or JSMN_ERROR_INVAL, if a path is invalid or there are more than
+ * JSMN_MATCH_PATHS paths, JSMN_MATCH_SEGMENTS segments or a path is longer
+ * than JSMN_MAX_DEPTH.
+ */
+int jsmn_matcher_compile(jsmn_Matcher *matcher, const char **paths,
+        size_t count);
+
+/**
+ * @brief Find all Paths in a Document
+ *
+ * Walks the tokens of the value 'toks[root]' once for all paths, skipping the
+ * subtrees no path leads into. The matches are stored in document order,
+ * where a path with wildcards may match several tokens.
+ *
+ * Returns the number of matches or JSMN_ERROR_NOMEM, if there are more than
+ * 'len' matches.
+ */
+int jsmn_match(const jsmn_Matcher *matcher, const char *js,
+        const jsmn_Token *toks, int root, jsmn_Match *matches, size_t len);
+
+/**
+ * @brief Parse the Projection of a JSON String
+ *
+ * Parses one value, but only creates tokens for the values matched by the
+ * paths of 'matcher' and for the objects and arrays (and their labels) on the
+ * way to them. Everything else is skipped by balancing brackets and strings
+ * only, without creating tokens or checking its syntax. The 'size' of an
+ * object or array is the number of its members or elements with tokens.
+ *
+ * The matches are stored like by 'jsmn_match'. As skipped array elements have
+ * no tokens, the tokens cannot be searched for array indices afterwards.
+ *
+ * The whole value has to be passed at once and the parser needs a token
+ * array or an allocator. Returns the number of matches, JSMN_ERROR_NOMEM if
+ * there are more than 'matcheslen' matches, or an error like 'jsmn_parse'.
+ */
+int jsmn_parse_projection(jsmn_Parser *parser, const jsmn_Matcher *matcher,
+        const char *js, size_t len, jsmn_Match *matches, size_t matcheslen);
+
+/**
+ * @brief Get the Integer of a Primitive
+ *
+ * Decodes the number 't' straight from its data, independent of the locale.
+ * It has to be an integer according to the JSON grammar, i.e. without
+ * fraction or exponent. Returns 0, JSMN_ERROR_INVAL if the token is no such
+ * number or JSMN_ERROR_RANGE if it does not fit into an int64_t.
+ */
+int jsmn_get_int64(const char *js, const jsmn_Token *t, int64_t *value);
+
+/**
+ * @brief Get the Unsigned Integer of a Primitive
+ *
+ * Like 'jsmn_get_int64', but returns JSMN_ERROR_RANGE for negative numbers.
+ */
+int jsmn_get_uint64(const char *js, const jsmn_Token *t, uint64_t *value);
+
+/**
+ * @brief Get the Double of a Primitive
+ *
+ * Decodes the number 't' straight from its data, independent of the locale
+ * and correctly rounded to the nearest double. Returns 0, JSMN_ERROR_INVAL if
+ * the token is not a number or JSMN_ERROR_RANGE if it is too large, in which
+ * case 'value' is set to an infinity. Numbers too small for a double give 0.
+ */
+int jsmn_get_double(const char *js, const jsmn_Token *t, double *value);
+
+/**
+ * @brief Get the Numbers of an Array
+ *
+ * Converts the elements of the closed array 'toks[array]' like
+ * 'jsmn_get_int64' into 'values'. Returns the number of elements,
+ * JSMN_ERROR_NOMEM if there are more than 'len' elements, or the error of the
+ * first element which cannot be converted.
+ */
+int jsmn_get_int64_array(const char *js, const jsmn_Token *toks, int array,
+        int64_t *values, size_t len);
+
+/**
+ * @brief Get the Unsigned Numbers of an Array
+ *
+ * Like 'jsmn_get_int64_array', but using 'jsmn_get_uint64'.
+ */
+int jsmn_get_uint64_array(const char *js, const jsmn_Token *toks, int array,
+        uint64_t *values, size_t len);
+
+/**
+ * @brief Get the Doubles of an Array
+ *
+ * Like 'jsmn_get_int64_array', but using 'jsmn_get_double'.
+ */
+int jsmn_get_double_array(const char *js, const jsmn_Token *toks, int array,
+        double *values, size_t len);
+
+/**
+ * @brief Get the Raw Data of a String without Escape Sequences
+ *
+ * Returns the data of the string or label 't', which can be used as it is
+ * with its 'length', or NULL if it has escape sequences and needs decoding.
+ */
+const char *jsmn_string_view(const char *js, const jsmn_Token *t);
+
+/**
+ * @brief Get the Decoded Length of a String
+ *
+ * Returns the number of bytes of the string or label 't' with its escape
+ * sequences decoded to UTF-8, or JSMN_ERROR_INVAL if the token is no string
+ * or has an invalid escape sequence.
+ */
+int jsmn_string_length(const char *js, const jsmn_Token *t);
+
+/**
+ * @brief Decode a String
+ *
+ * Decodes the escape sequences of the string or label 't' into the buffer
+ * 'buf' of 'len' bytes, '\uXXXX' and surrogate pairs to UTF-8. Lone
+ * surrogates are replaced by U+FFFD. The result is not NUL terminated. As the
+ * decoded string is never longer than the raw one, the token data itself may
+ * be passed as 'buf' to decode the string in place.
+ *
+ * Returns the number of decoded bytes, JSMN_ERROR_NOMEM if they do not fit
+ * into 'buf' or JSMN_ERROR_INVAL like 'jsmn_string_length'.
+ */
+int jsmn_string_decode(const char *js, const jsmn_Token *t, char *buf,
+        size_t len);
+
 #ifdef __cplusplus
 }
 #endif
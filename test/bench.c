@@ -0,0 +1,761 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+#ifdef JSMN_THREADS
+#include <unistd.h>
+#endif
+
+#include "../jsmn.c"
+
+/*
+ * Parser benchmark on large generated documents. It prints the size of the
+ * tokens, the memory needed for the token array and the parse throughput, so
+ * builds with different options (e.g. JSMN_COMPACT_TOKENS) can be compared.
+ */
+
+#define BENCH_SIZE (64 * 1024 * 1024)
+#define BENCH_RUNS 5
+
+typedef size_t (*bench_gen_t)(char *buf, size_t i);
+
+static size_t gen_records(char *buf, size_t i) {
+	return sprintf(buf, "{\"id\": %zu, \"name\": \"user%zu\", \"active\": %s, "
+			"\"tags\": [\"a\", \"b\", \"c\"], \"pos\": {\"x\": %zu.5, "
+			"\"y\": -%zu.25}}", i, i, i % 2 ? "true" : "false", i % 1000,
+			i % 777);
+}
+
+static size_t gen_numbers(char *buf, size_t i) {
+	return sprintf(buf, "%zu", i * 7919);
+}
+
+static size_t gen_floats(char *buf, size_t i) {
+	return sprintf(buf, "%.*g", (int)(i % 17) + 1, (double)i * 0.7919 + 1e-3);
+}
+
+static size_t gen_strings(char *buf, size_t i) {
+	return sprintf(buf, "\"%zu: the quick brown fox jumps over the lazy dog, "
+			"again and again and again\"", i);
+}
+
+/* Arrays nested deeper than the default stack of the parser */
+static size_t gen_deep(char *buf, size_t i) {
+	size_t depth = 100;
+	size_t n;
+	memset(buf, '[', depth);
+	n = depth + sprintf(buf + depth, "{\"k\": %zu}", i);
+	memset(buf + n, ']', depth);
+	return n + depth;
+}
+
+/* Generates an array of values of about BENCH_SIZE bytes */
+static char *generate(bench_gen_t gen, size_t *len) {
+	char *js = malloc(BENCH_SIZE + 1024);
+	size_t n = 0;
+	size_t i;
+
+	if (js == NULL) {
+		return NULL;
+	}
+	js[n++] = '[';
+	for (i = 0; n < BENCH_SIZE; i++) {
+		if (i > 0) {
+			n += sprintf(js + n, ",\n");
+		}
+		n += gen(js + n, i);
+	}
+	js[n++] = ']';
+	js[n] = '\0';
+	*len = n;
+	return js;
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int bench(const char *name, bench_gen_t gen) {
+	jsmn_Parser p;
+	jsmn_Token *toks;
+	size_t len;
+	double best = 0;
+	double counting = 0;
+	int count;
+	int i;
+	char *js = generate(gen, &len);
+
+	if (js == NULL) {
+		return -1;
+	}
+	/* The counting pass sizing the token array */
+	for (i = 0; i < BENCH_RUNS; i++) {
+		double t = now();
+		jsmn_parser_init(&p, NULL, 0);
+		count = jsmn_parse(&p, js, len);
+		t = now() - t;
+		if (i == 0 || t < counting) {
+			counting = t;
+		}
+	}
+	toks = malloc(count * sizeof(jsmn_Token));
+	if (count < 0 || toks == NULL) {
+		free(js);
+		return -1;
+	}
+	for (i = 0; i < BENCH_RUNS; i++) {
+		double t = now();
+		jsmn_parser_init(&p, toks, count);
+		if (jsmn_parse(&p, js, len) != count) {
+			free(toks);
+			free(js);
+			return -1;
+		}
+		t = now() - t;
+		if (i == 0 || t < best) {
+			best = t;
+		}
+	}
+	printf("%-8s %6.1f MB %9d tokens %7.1f MB tokens %8.1f MB/s "
+			"(counting %.1f MB/s)\n", name, len / 1e6, count,
+			count * sizeof(jsmn_Token) / 1e6, len / 1e6 / best,
+			len / 1e6 / counting);
+	free(toks);
+	free(js);
+	return 0;
+}
+
+/* Parses only the values of 'paths' */
+static int bench_projection(const char *name, bench_gen_t gen,
+		const char **paths, size_t n) {
+	jsmn_Parser p;
+	jsmn_Matcher m;
+	jsmn_Match *matches;
+	jsmn_Token *toks;
+	size_t len;
+	double best = 0;
+	int count = 0;
+	int i;
+	char *js = generate(gen, &len);
+
+	if (js == NULL || jsmn_matcher_compile(&m, paths, n) < 0) {
+		free(js);
+		return -1;
+	}
+	toks = malloc(BENCH_SIZE / 2 * sizeof(jsmn_Token));
+	matches = malloc(BENCH_SIZE / 2 * sizeof(jsmn_Match));
+	for (i = 0; toks != NULL && matches != NULL && i < BENCH_RUNS; i++) {
+		double t = now();
+		jsmn_parser_init(&p, toks, BENCH_SIZE / 2);
+		count = jsmn_parse_projection(&p, &m, js, len, matches,
+				BENCH_SIZE / 2);
+		if (count < 0) {
+			break;
+		}
+		t = now() - t;
+		if (i == 0 || t < best) {
+			best = t;
+		}
+	}
+	free(matches);
+	free(toks);
+	free(js);
+	if (i < BENCH_RUNS) {
+		return -1;
+	}
+	printf("%-8s %6.1f MB %9d tokens %7.1f MB tokens %8.1f MB/s "
+			"(%d matches)\n", name, len / 1e6, p.factory.toknext,
+			p.factory.toknext * sizeof(jsmn_Token) / 1e6, len / 1e6 / best,
+			count);
+	return 0;
+}
+
+/* Decodes every element of an array of numbers into doubles */
+static int bench_decode(const char *name, bench_gen_t gen) {
+	jsmn_Parser p;
+	jsmn_Token *toks;
+	double *values;
+	size_t len;
+	double best = 0;
+	double sum = 0;
+	int count;
+	int i;
+	char *js = generate(gen, &len);
+
+	if (js == NULL) {
+		return -1;
+	}
+	jsmn_parser_init(&p, NULL, 0);
+	count = jsmn_parse(&p, js, len);
+	toks = malloc(count * sizeof(jsmn_Token));
+	values = malloc(count * sizeof(double));
+	jsmn_parser_init(&p, toks, count);
+	if (count < 0 || toks == NULL || jsmn_parse(&p, js, len) != count) {
+		count = 0;
+	}
+	for (i = 0; count > 0 && values != NULL && i < BENCH_RUNS; i++) {
+		double t = now();
+		if (jsmn_get_double_array(js, toks, 0, values, count) < 0) {
+			break;
+		}
+		t = now() - t;
+		if (i == 0 || t < best) {
+			best = t;
+		}
+		sum += values[toks[0].size - 1];
+	}
+	if (i == BENCH_RUNS) {
+		printf("%-8s %6.1f MB %9d values %8.1f MB/s %8.1f Mvalues/s\n", name,
+				len / 1e6, toks[0].size, len / 1e6 / best,
+				toks[0].size / 1e6 / best);
+	}
+	free(values);
+	free(toks);
+	free(js);
+	return i == BENCH_RUNS && sum != 0 ? 0 : -1;
+}
+
+/* Parses newline delimited records line by line and as one batch */
+static int bench_records(const char *name, bench_gen_t gen) {
+	jsmn_Parser p;
+	jsmn_Token *toks;
+	jsmn_Record *recs;
+	char *js = malloc(BENCH_SIZE + 1024);
+	size_t len = 0;
+	size_t n = 0;
+	size_t i;
+	double lines = 0;
+	double batch = 0;
+	int count = 0;
+	int run;
+
+	for (i = 0; js != NULL && len < BENCH_SIZE; i++, n++) {
+		len += gen(js + len, i);
+		js[len++] = '\n';
+	}
+	toks = malloc(BENCH_SIZE / 2 * sizeof(jsmn_Token));
+	recs = malloc(n * sizeof(jsmn_Record));
+	for (run = 0; toks != NULL && recs != NULL && run < BENCH_RUNS; run++) {
+		const char *line = js;
+		size_t used = 0;
+		double t = now();
+		while (line < js + len) {
+			/* A parser for each record, keeping the tokens of all */
+			const char *nl = memchr(line, '\n', js + len - line);
+			jsmn_parser_init(&p, toks + used, BENCH_SIZE / 2 - used);
+			if (jsmn_parse(&p, line, nl - line + 1) < 0) {
+				break;
+			}
+			used += p.factory.toknext;
+			line = nl + 1;
+		}
+		t = now() - t;
+		if (run == 0 || t < lines) {
+			lines = t;
+		}
+		t = now();
+		jsmn_parser_init(&p, toks, BENCH_SIZE / 2);
+		count = jsmn_parse_records(&p, js, len, recs, n);
+		t = now() - t;
+		if (run == 0 || t < batch) {
+			batch = t;
+		}
+		if (line != js + len || count != (int)n) {
+			break;
+		}
+	}
+	free(recs);
+	free(toks);
+	free(js);
+	if (run < BENCH_RUNS) {
+		return -1;
+	}
+	printf("%-8s %6.1f MB %9d records %8.1f MB/s (line by line %.1f MB/s)\n",
+			name, len / 1e6, count, len / 1e6 / batch, len / 1e6 / lines);
+	return 0;
+}
+
+static char *dump_out;
+
+static int dump_cb(const char *data, size_t length) {
+	memcpy(dump_out, data, length);
+	dump_out += length;
+	return 0;
+}
+
+/* Dumps the tokens with a callback per fragment and with a writer */
+static int bench_dump(const char *name, bench_gen_t gen) {
+	jsmn_Parser p;
+	jsmn_Token *toks;
+	jsmn_Writer w;
+	size_t len;
+	double calls = 0;
+	double writer = 0;
+	double escaping = 0;
+	int count;
+	int i;
+	int run;
+	char *js = generate(gen, &len);
+	char *out = malloc(BENCH_SIZE + 1024);
+
+	jsmn_parser_init(&p, NULL, 0);
+	count = js != NULL ? jsmn_parse(&p, js, len) : -1;
+	toks = count > 0 ? malloc(count * sizeof(jsmn_Token)) : NULL;
+	jsmn_parser_init(&p, toks, count);
+	if (out == NULL || toks == NULL || jsmn_parse(&p, js, len) != count) {
+		run = 0;
+		goto out;
+	}
+	for (run = 0; run < BENCH_RUNS; run++) {
+		double t = now();
+		dump_out = out;
+		jsmn_dump_js(js, toks, dump_cb);
+		t = now() - t;
+		if (run == 0 || t < calls) {
+			calls = t;
+		}
+		t = now();
+		jsmn_writer_init(&w, out, BENCH_SIZE + 1024, NULL, NULL);
+		if (jsmn_dump_writer(js, toks, &w) != count ||
+				w.len != (size_t)(dump_out - out)) {
+			break;
+		}
+		t = now() - t;
+		if (run == 0 || t < writer) {
+			writer = t;
+		}
+	}
+	/* The same strings checked for characters to escape */
+	for (i = 0; i < count; i++) {
+		if (toks[i].type == JSMN_STRING || toks[i].type == JSMN_LABEL) {
+			toks[i].flags |= JSMN_FLAG_RAW;
+		}
+	}
+	for (i = 0; run == BENCH_RUNS && i < BENCH_RUNS; i++) {
+		double t = now();
+		jsmn_writer_init(&w, out, BENCH_SIZE + 1024, NULL, NULL);
+		if (jsmn_dump_writer(js, toks, &w) != count) {
+			run = 0;
+		}
+		t = now() - t;
+		if (i == 0 || t < escaping) {
+			escaping = t;
+		}
+	}
+	if (run == BENCH_RUNS) {
+		printf("%-8s %6.1f MB %8.1f MB/s (callbacks %.1f MB/s, escaping "
+				"%.1f MB/s)\n", name, w.len / 1e6, w.len / 1e6 / writer,
+				w.len / 1e6 / calls, w.len / 1e6 / escaping);
+	}
+out:
+	free(out);
+	free(toks);
+	free(js);
+	return run == BENCH_RUNS ? 0 : -1;
+}
+
+/* Sink counting the output instead of keeping it */
+static int count_sink(void *ctx, const jsmn_Fragment *frags, int count) {
+	int i;
+	for (i = 0; i < count; i++) {
+		*(size_t *)ctx += frags[i].length;
+	}
+	return 0;
+}
+
+/* The recursive dump the serialiser replaced, kept as the baseline */
+static int dump_recursive(const char *js, jsmn_Token *t, jsmn_Writer *w) {
+	int i;
+	int j = 0;
+
+	if (t->type == JSMN_PRIMITIVE) {
+		jsmn_put(w, jsmn_token_data(js, t), t->length);
+		return 1;
+	} else if (t->type == JSMN_LABEL || t->type == JSMN_STRING) {
+		jsmn_put_string(js, t, w);
+		if (t->type == JSMN_LABEL) {
+			jsmn_put(w, ":", 1);
+		}
+		return 1;
+	} else if (t->type != JSMN_OBJECT && t->type != JSMN_ARRAY) {
+		return 0;
+	}
+	jsmn_put(w, t->type == JSMN_OBJECT ? "{" : "[", 1);
+	for (i = 0; i < t->size; i++) {
+		if (i > 0) {
+			jsmn_put(w, ",", 1);
+		}
+		j += dump_recursive(js, t + 1 + j, w);
+		if (t->type == JSMN_OBJECT) {
+			j += dump_recursive(js, t + 1 + j, w);
+		}
+	}
+	jsmn_put(w, t->type == JSMN_OBJECT ? "}" : "]", 1);
+	return j + 1;
+}
+
+/* Serialises the tokens to a writer and returns the seconds taken */
+static double serialize(const char *js, jsmn_Token *toks, int count,
+		int indent, size_t *len) {
+	static char buf[64 * 1024];
+	jsmn_Writer w;
+	int r;
+	double t = now();
+
+	*len = 0;
+	jsmn_writer_init(&w, buf, sizeof(buf), count_sink, len);
+	if (indent < 0) {
+		r = dump_recursive(js, toks, &w);
+	} else {
+		r = jsmn_serialize(js, toks, &w, indent);
+	}
+	jsmn_writer_flush(&w);
+	t = now() - t;
+	return r == count ? t : -1;
+}
+
+/* Serialises the tokens with the recursive dump and without recursion */
+static int bench_serialize(const char *name, bench_gen_t gen) {
+	jsmn_Parser p;
+	jsmn_Token *toks = NULL;
+	size_t len;
+	size_t compact = 0;
+	size_t indented = 0;
+	double best[3] = { 0, 0, 0 };
+	int count;
+	int run;
+	int i;
+	char *js = generate(gen, &len);
+
+	jsmn_parser_init(&p, NULL, 0);
+	count = js != NULL ? jsmn_parse(&p, js, len) : -1;
+	toks = count > 0 ? malloc(count * sizeof(jsmn_Token)) : NULL;
+	jsmn_parser_init(&p, toks, count);
+	for (run = 0; toks != NULL && jsmn_parse(&p, js, len) == count &&
+			run < BENCH_RUNS; run++) {
+		/* Recursive, iterative and iterative indented by two spaces */
+		for (i = 0; i < 3; i++) {
+			double t = serialize(js, toks, count, i - 1,
+					i < 2 ? &compact : &indented);
+			if (t < 0) {
+				break;
+			}
+			if (run == 0 || t < best[i]) {
+				best[i] = t;
+			}
+		}
+		if (i < 3) {
+			break;
+		}
+	}
+	free(toks);
+	free(js);
+	if (run < BENCH_RUNS) {
+		return -1;
+	}
+	printf("%-8s %6.1f MB %8.1f MB/s (recursive %.1f MB/s, indented "
+			"%.1f MB/s)\n", name, compact / 1e6, compact / 1e6 / best[1],
+			compact / 1e6 / best[0], indented / 1e6 / best[2]);
+	return 0;
+}
+
+#define BENCH_NUMBERS (4 * 1024 * 1024)
+
+/* Builds an array of numbers formatted with snprintf and by the factory */
+static int bench_append(const char *name, int floats) {
+	jsmn_Factory f;
+	jsmn_Token *toks = malloc((BENCH_NUMBERS + 1) * sizeof(jsmn_Token));
+	char *chars = malloc(BENCH_NUMBERS * 25);
+	double printf_best = 0;
+	double append_best = 0;
+	size_t i;
+	int run;
+
+	for (run = 0; toks != NULL && chars != NULL && run < BENCH_RUNS; run++) {
+		char *p = chars;
+		double t = now();
+		jsmn_factory_init(&f, toks, BENCH_NUMBERS + 1);
+		jsmn_start_array(&f, NULL);
+		for (i = 0; i < BENCH_NUMBERS; i++) {
+			if (floats) {
+				snprintf(p, 25, "%.17g", i * 0.7919 + 1e-3);
+			} else {
+				snprintf(p, 25, "%" PRId64, (int64_t)(i * 7919) - 1000000);
+			}
+			jsmn_append_primitive(&f, NULL, p);
+			p += strlen(p) + 1;
+		}
+		jsmn_end_array(&f);
+		t = now() - t;
+		if (run == 0 || t < printf_best) {
+			printf_best = t;
+		}
+		t = now();
+		jsmn_factory_init(&f, toks, BENCH_NUMBERS + 1);
+		jsmn_factory_storage(&f, chars, BENCH_NUMBERS * 25);
+		jsmn_start_array(&f, NULL);
+		for (i = 0; i < BENCH_NUMBERS; i++) {
+			if (floats) {
+				jsmn_append_double(&f, NULL, i * 0.7919 + 1e-3);
+			} else {
+				jsmn_append_int64(&f, NULL, (int64_t)(i * 7919) - 1000000);
+			}
+		}
+		if (jsmn_end_array(&f) != BENCH_NUMBERS + 1) {
+			break;
+		}
+		t = now() - t;
+		if (run == 0 || t < append_best) {
+			append_best = t;
+		}
+	}
+	free(chars);
+	free(toks);
+	if (run < BENCH_RUNS) {
+		return -1;
+	}
+	printf("%-8s %9d numbers %8.1f M/s (snprintf %.1f M/s)\n", name,
+			BENCH_NUMBERS, BENCH_NUMBERS / 1e6 / append_best,
+			BENCH_NUMBERS / 1e6 / printf_best);
+	return 0;
+}
+
+#define BENCH_DOCS (256 * 1024)
+#define BENCH_MEMBERS 16
+
+/* Builds small documents from strings with and without an arena */
+static int bench_build(void) {
+	static const char *names[BENCH_MEMBERS] = { "id", "name", "email",
+		"created", "updated", "status", "owner", "group", "region", "zone",
+		"kind", "version", "checksum", "parent", "title", "description" };
+	static const char *values[BENCH_MEMBERS] = { "4711", "john doe",
+		"john@example.com", "2020-01-01T00:00:00Z", "2021-02-03T04:05:06Z",
+		"active", "root", "admin", "eu-central", "a", "user", "12",
+		"0123456789abcdef", "none", "the title of the document",
+		"a longer description of the document which is built" };
+	size_t namelen[BENCH_MEMBERS];
+	size_t valuelen[BENCH_MEMBERS];
+	jsmn_Token toks[BENCH_MEMBERS * 2 + 1];
+	char arena[1024];
+	jsmn_Factory f;
+	double plain = 0;
+	double copied = 0;
+	int run;
+	int i;
+	int j;
+
+	for (i = 0; i < BENCH_MEMBERS; i++) {
+		namelen[i] = strlen(names[i]);
+		valuelen[i] = strlen(values[i]);
+	}
+	for (run = 0; run < BENCH_RUNS; run++) {
+		double t = now();
+		for (i = 0; i < BENCH_DOCS; i++) {
+			jsmn_factory_init(&f, toks, BENCH_MEMBERS * 2 + 1);
+#ifdef JSMN_COMPACT_TOKENS
+			/* Compact tokens need the strings within reach of the base */
+			jsmn_factory_arena(&f, arena, sizeof(arena));
+#endif
+			jsmn_start_object(&f, NULL);
+			for (j = 0; j < BENCH_MEMBERS; j++) {
+				jsmn_append_string(&f, names[j], values[j]);
+			}
+			if (jsmn_end_object(&f) != BENCH_MEMBERS * 2 + 1) {
+				return -1;
+			}
+		}
+		t = now() - t;
+		if (run == 0 || t < plain) {
+			plain = t;
+		}
+		t = now();
+		jsmn_factory_init(&f, toks, BENCH_MEMBERS * 2 + 1);
+		jsmn_factory_arena(&f, arena, sizeof(arena));
+		for (i = 0; i < BENCH_DOCS; i++) {
+			jsmn_factory_reset(&f);
+			jsmn_start_object_len(&f, NULL, 0);
+			for (j = 0; j < BENCH_MEMBERS; j++) {
+				jsmn_append_string_len(&f, names[j], namelen[j], values[j],
+						valuelen[j]);
+			}
+			if (jsmn_end_object(&f) != BENCH_MEMBERS * 2 + 1) {
+				return -1;
+			}
+		}
+		t = now() - t;
+		if (run == 0 || t < copied) {
+			copied = t;
+		}
+	}
+	printf("%-8s %9d documents %6.1f M/s (strlen %.1f M/s)\n",
+			"build", BENCH_DOCS, BENCH_DOCS / 1e6 / copied,
+			BENCH_DOCS / 1e6 / plain);
+	return 0;
+}
+
+#ifdef JSMN_THREADS
+static jsmn_Token *grow_tokens(void *ctx, jsmn_Token *toks, size_t len) {
+	return realloc(toks, len * sizeof(*toks));
+}
+
+static void free_tokens(void *ctx, jsmn_Token *toks) {
+	free(toks);
+}
+
+static int count_records(void *ctx, const char *js, const jsmn_Token *toks,
+		const jsmn_Record *records, int count) {
+	*(size_t *)ctx += count;
+	return 0;
+}
+
+/* Parses newline delimited records with 1 up to all cores */
+static int bench_parallel(const char *name, bench_gen_t gen) {
+	jsmn_Allocator alloc = { grow_tokens, free_tokens, NULL };
+	char *js = malloc(BENCH_SIZE + 1024);
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t len = 0;
+	size_t i;
+	unsigned int threads;
+	double single = 0;
+	int run;
+
+	for (i = 0; js != NULL && len < BENCH_SIZE; i++) {
+		len += gen(js + len, i);
+		js[len++] = '\n';
+	}
+	if (js == NULL) {
+		return -1;
+	}
+	for (threads = 1; threads <= (cores > 1 ? cores : 1); ) {
+		double best = 0;
+		for (run = 0; run < BENCH_RUNS; run++) {
+			size_t count = 0;
+			double t = now();
+			if (jsmn_parse_parallel(js, len, threads, &alloc, count_records,
+					&count) != (int)i || count != i) {
+				free(js);
+				return -1;
+			}
+			t = now() - t;
+			if (run == 0 || t < best) {
+				best = t;
+			}
+		}
+		if (threads == 1) {
+			single = best;
+		}
+		printf("%-8s %6.1f MB %3u threads %8.1f MB/s (speedup %.2f)\n",
+				name, len / 1e6, threads, len / 1e6 / best, single / best);
+		/* Doubling the threads, but ending with all cores */
+		threads = threads < cores && threads * 2 > cores ? cores : threads * 2;
+	}
+	free(js);
+	return 0;
+}
+
+/* Parses one document with 1 up to all cores */
+static int bench_split(const char *name, bench_gen_t gen) {
+	jsmn_Allocator alloc = { grow_tokens, free_tokens, NULL };
+	jsmn_Parser p;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t len;
+	unsigned int threads;
+	double single = 0;
+	int count = -1;
+	int run;
+	char *js = generate(gen, &len);
+
+	if (js == NULL) {
+		return -1;
+	}
+	for (threads = 1; threads <= (cores > 1 ? cores : 1); ) {
+		double best = 0;
+		for (run = 0; run < BENCH_RUNS; run++) {
+			double t = now();
+			int r;
+			jsmn_parser_init_alloc(&p, &alloc);
+			r = jsmn_parse_split(&p, js, len, threads);
+			t = now() - t;
+			jsmn_factory_free(&p.factory);
+			if (r < 0 || (count >= 0 && r != count)) {
+				free(js);
+				return -1;
+			}
+			count = r;
+			if (run == 0 || t < best) {
+				best = t;
+			}
+		}
+		if (threads == 1) {
+			single = best;
+		}
+		printf("%-8s %6.1f MB %3u threads %8.1f MB/s (speedup %.2f)\n",
+				name, len / 1e6, threads, len / 1e6 / best, single / best);
+		threads = threads < cores && threads * 2 > cores ? cores : threads * 2;
+	}
+	free(js);
+	return 0;
+}
+#endif
+
+int main(void) {
+	const char *one[] = { "/1000/pos/x" };
+	const char *each[] = { "/*/id", "/*/pos/y" };
+
+	printf("sizeof(jsmn_Token) = %zu\n", sizeof(jsmn_Token));
+	if (bench("records", gen_records) < 0 ||
+			bench("numbers", gen_numbers) < 0 ||
+			bench("strings", gen_strings) < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+	printf("decoding:\n");
+	if (bench_decode("floats", gen_floats) < 0 ||
+			bench_decode("integers", gen_numbers) < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+	printf("records:\n");
+	if (bench_records("records", gen_records) < 0 ||
+			bench_records("numbers", gen_numbers) < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+	printf("dump:\n");
+	if (bench_dump("records", gen_records) < 0 ||
+			bench_dump("strings", gen_strings) < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+	printf("append:\n");
+	if (bench_append("integers", 0) < 0 || bench_append("floats", 1) < 0 ||
+			bench_build() < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+	printf("serialize:\n");
+	if (bench_serialize("records", gen_records) < 0 ||
+			bench_serialize("numbers", gen_numbers) < 0 ||
+			bench_serialize("deep", gen_deep) < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+#ifdef JSMN_THREADS
+	printf("parallel:\n");
+	if (bench_parallel("records", gen_records) < 0 ||
+			bench_split("split", gen_records) < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+#endif
+	printf("projection:\n");
+	if (bench_projection("one", gen_records, one, 1) < 0 ||
+			bench_projection("each", gen_records, each, 2) < 0) {
+		printf("benchmark failed\n");
+		return 1;
+	}
+	return 0;
+}
@@ -21,31 +21,31 @@ int test_empty(void) {
 int test_object(void) {
 	check(parse("{\"a\":0}", 3, 3,
 				JSMN_OBJECT, 0, 7, 1,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_PRIMITIVE, "0"));
 	check(parse("{\"a\":[]}", 3, 3,
 				JSMN_OBJECT, 0, 8, 1,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_ARRAY, 5, 7, 0));
 	check(parse("{\"a\":{},\"b\":{}}", 5, 5,
 				JSMN_OBJECT, -1, -1, 2,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_OBJECT, -1, -1, 0,
-				JSMN_STRING, "b", 1,
+				JSMN_LABEL, "b", 1,
 				JSMN_OBJECT, -1, -1, 0));
 	check(parse("{\n \"Day\": 26,\n \"Month\": 9,\n \"Year\": 12\n }", 7, 7,
 				JSMN_OBJECT, -1, -1, 3,
-				JSMN_STRING, "Day", 1,
+				JSMN_LABEL, "Day", 1,
 				JSMN_PRIMITIVE, "26",
-				JSMN_STRING, "Month", 1,
+				JSMN_LABEL, "Month", 1,
 				JSMN_PRIMITIVE, "9",
-				JSMN_STRING, "Year", 1,
+				JSMN_LABEL, "Year", 1,
 				JSMN_PRIMITIVE, "12"));
 	check(parse("{\"a\": 0, \"b\": \"c\"}", 5, 5,
 				JSMN_OBJECT, -1, -1, 2,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_PRIMITIVE, "0",
-				JSMN_STRING, "b", 1,
+				JSMN_LABEL, "b", 1,
 				JSMN_STRING, "c", 0));
 
 #ifdef JSMN_STRICT
@@ -54,82 +54,114 @@ int test_object(void) {
 	check(parse("{\"a\": {2}}", JSMN_ERROR_INVAL, 3));
 	check(parse("{\"a\": {2: 3}}", JSMN_ERROR_INVAL, 3));
 	check(parse("{\"a\": {\"a\": 2 3}}", JSMN_ERROR_INVAL, 5));
-	/* FIXME */
-	/*check(parse("{\"a\"}", JSMN_ERROR_INVAL, 2));*/
-	/*check(parse("{\"a\": 1, \"b\"}", JSMN_ERROR_INVAL, 4));*/
-	/*check(parse("{\"a\",\"b\":1}", JSMN_ERROR_INVAL, 4));*/
-	/*check(parse("{\"a\":1,}", JSMN_ERROR_INVAL, 4));*/
-	/*check(parse("{\"a\":\"b\":\"c\"}", JSMN_ERROR_INVAL, 4));*/
-	/*check(parse("{,}", JSMN_ERROR_INVAL, 4));*/
+	check(parse("{\"a\"}", JSMN_ERROR_INVAL, 2));
+	check(parse("{\"a\": 1, \"b\"}", JSMN_ERROR_INVAL, 4));
+	check(parse("{\"a\",\"b\":1}", JSMN_ERROR_INVAL, 4));
+	check(parse("{\"a\":1,}", JSMN_ERROR_INVAL, 4));
+	check(parse("{\"a\":\"b\":\"c\"}", JSMN_ERROR_INVAL, 4));
+	check(parse("{,}", JSMN_ERROR_INVAL, 4));
 #endif
 	return 0;
 }
 
 int test_array(void) {
-	/* FIXME */
-	/*check(parse("[10}", JSMN_ERROR_INVAL, 3));*/
-	/*check(parse("[1,,3]", JSMN_ERROR_INVAL, 3)*/
+	check(parse("[10}", JSMN_ERROR_INVAL, 3));
+#ifdef JSMN_STRICT
+	check(parse("[1,,3]", JSMN_ERROR_INVAL, 3));
+#endif
 	check(parse("[10]", 2, 2,
 				JSMN_ARRAY, -1, -1, 1,
 				JSMN_PRIMITIVE, "10"));
 	check(parse("{\"a\": 1]", JSMN_ERROR_INVAL, 3));
-	/* FIXME */
-	/*check(parse("[\"a\": 1]", JSMN_ERROR_INVAL, 3));*/
+#ifdef JSMN_STRICT
+	check(parse("[\"a\": 1]", JSMN_ERROR_INVAL, 3));
+#endif
 	return 0;
 }
 
 int test_primitive(void) {
 	check(parse("{\"boolVar\" : true }", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "boolVar", 1,
+				JSMN_LABEL, "boolVar", 1,
 				JSMN_PRIMITIVE, "true"));
 	check(parse("{\"boolVar\" : false }", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "boolVar", 1,
+				JSMN_LABEL, "boolVar", 1,
 				JSMN_PRIMITIVE, "false"));
 	check(parse("{\"nullVar\" : null }", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "nullVar", 1,
+				JSMN_LABEL, "nullVar", 1,
 				JSMN_PRIMITIVE, "null"));
 	check(parse("{\"intVar\" : 12}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "intVar", 1,
+				JSMN_LABEL, "intVar", 1,
 				JSMN_PRIMITIVE, "12"));
 	check(parse("{\"floatVar\" : 12.345}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "floatVar", 1,
+				JSMN_LABEL, "floatVar", 1,
 				JSMN_PRIMITIVE, "12.345"));
 	return 0;
 }
 
+int test_primitive_kind(void) {
+	int i;
+	jsmn_Parser p;
+	jsmn_Token t[16];
+	const char *js = "[0, -12, 1.5, -0e+3, 2E-1, true, false, null]";
+	const char *bad[] = { "[tru]", "[nulls]", "[-]", "[01]", "[1.]",
+		"[1e]", "[1e+]", "[0x1]", "[1-2]", "[-true]" };
+	jsmnkind_t kinds[] = { JSMN_KIND_INTEGER, JSMN_KIND_INTEGER,
+		JSMN_KIND_FLOAT, JSMN_KIND_FLOAT, JSMN_KIND_FLOAT, JSMN_KIND_TRUE,
+		JSMN_KIND_FALSE, JSMN_KIND_NULL };
+
+	jsmn_parser_init(&p, t, 16);
+	check(jsmn_parse(&p, js, strlen(js)) == 9);
+	for (i = 0; i < 8; i++) {
+		check(jsmn_primitive_kind(&t[i + 1]) == kinds[i]);
+	}
+	for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+		jsmn_parser_init(&p, t, 16);
+#ifdef JSMN_STRICT
+		check(jsmn_parse(&p, bad[i], strlen(bad[i])) == JSMN_ERROR_INVAL);
+		/* The counting pass rejects them as well */
+		jsmn_parser_init(&p, NULL, 0);
+		check(jsmn_parse(&p, bad[i], strlen(bad[i])) == JSMN_ERROR_INVAL);
+#else
+		check(jsmn_parse(&p, bad[i], strlen(bad[i])) == 2);
+		check(jsmn_primitive_kind(&t[1]) == JSMN_KIND_INVALID);
+#endif
+	}
+	return 0;
+}
+
 int test_string(void) {
 	check(parse("{\"strVar\" : \"hello world\"}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "strVar", 1,
+				JSMN_LABEL, "strVar", 1,
 				JSMN_STRING, "hello world", 0));
 	check(parse("{\"strVar\" : \"escapes: \\/\\r\\n\\t\\b\\f\\\"\\\\\"}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "strVar", 1,
+				JSMN_LABEL, "strVar", 1,
 				JSMN_STRING, "escapes: \\/\\r\\n\\t\\b\\f\\\"\\\\", 0));
 	check(parse("{\"strVar\": \"\"}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "strVar", 1,
+				JSMN_LABEL, "strVar", 1,
 				JSMN_STRING, "", 0));
 	check(parse("{\"a\":\"\\uAbcD\"}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_STRING, "\\uAbcD", 0));
 	check(parse("{\"a\":\"str\\u0000\"}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_STRING, "str\\u0000", 0));
 	check(parse("{\"a\":\"\\uFFFFstr\"}", 3, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_STRING, "\\uFFFFstr", 0));
 	check(parse("{\"a\":[\"\\u0280\"]}", 4, 4,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_ARRAY, -1, -1, 1,
 				JSMN_STRING, "\\u0280", 0));
 
@@ -139,23 +171,40 @@ int test_string(void) {
 	return 0;
 }
 
+int test_string_flags(void) {
+	int r;
+	jsmn_Parser p;
+	jsmn_Token tok[6];
+	const char *js = "{\"plain\": \"no escapes here\", \"e\\u0073c\": "
+		"\"tab\\there\"}";
+
+	jsmn_parser_init(&p, tok, 6);
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == 5);
+	check(tok[1].flags == 0);
+	check(tok[2].flags == 0);
+	check((tok[3].flags & JSMN_FLAG_ESCAPED) != 0);
+	check((tok[4].flags & JSMN_FLAG_ESCAPED) != 0);
+	return 0;
+}
+
 int test_partial_string(void) {
 	int i;
 	int r;
-	jsmn_parser p;
-	jsmntok_t tok[5];
+	jsmn_Parser p;
+	jsmn_Token tok[5];
 	const char *js = "{\"x\": \"va\\\\ue\", \"y\": \"value y\"}";
 
-	jsmn_init(&p);
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
 	for (i = 1; i <= strlen(js); i++) {
-		r = jsmn_parse(&p, js, i, tok, sizeof(tok)/sizeof(tok[0]));
+		r = jsmn_parse(&p, js, i);
 		if (i == strlen(js)) {
 			check(r == 5);
 			check(tokeq(js, tok, 5,
 					JSMN_OBJECT, -1, -1, 2,
-					JSMN_STRING, "x", 1,
+					JSMN_LABEL, "x", 1,
 					JSMN_STRING, "va\\\\ue", 0,
-					JSMN_STRING, "y", 1,
+					JSMN_LABEL, "y", 1,
 					JSMN_STRING, "value y", 0));
 		} else {
 			check(r == JSMN_ERROR_PART);
@@ -168,13 +217,13 @@ int test_partial_array(void) {
 #ifdef JSMN_STRICT
 	int r;
 	int i;
-	jsmn_parser p;
-	jsmntok_t tok[10];
+	jsmn_Parser p;
+	jsmn_Token tok[10];
 	const char *js = "[ 1, true, [123, \"hello\"]]";
 
-	jsmn_init(&p);
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
 	for (i = 1; i <= strlen(js); i++) {
-		r = jsmn_parse(&p, js, i, tok, sizeof(tok)/sizeof(tok[0]));
+		r = jsmn_parse(&p, js, i);
 		if (i == strlen(js)) {
 			check(r == 6);
 			check(tokeq(js, tok, 6,
@@ -195,22 +244,24 @@ int test_partial_array(void) {
 int test_array_nomem(void) {
 	int i;
 	int r;
-	jsmn_parser p;
-	jsmntok_t toksmall[10], toklarge[10];
+	jsmn_Parser p;
+	jsmn_Token toksmall[10], toklarge[10];
 	const char *js;
 
 	js = "  [ 1, true, [123, \"hello\"]]";
 
 	for (i = 0; i < 6; i++) {
-		jsmn_init(&p);
 		memset(toksmall, 0, sizeof(toksmall));
 		memset(toklarge, 0, sizeof(toklarge));
-		r = jsmn_parse(&p, js, strlen(js), toksmall, i);
+		jsmn_parser_init(&p, toksmall, i);
+		r = jsmn_parse(&p, js, strlen(js));
 		check(r == JSMN_ERROR_NOMEM);
 
 		memcpy(toklarge, toksmall, sizeof(toksmall));
 
-		r = jsmn_parse(&p, js, strlen(js), toklarge, 10);
+		p.factory.toks = toklarge;
+		p.factory.tokslen = 10;
+		r = jsmn_parse(&p, js, strlen(js));
 		check(r >= 0);
 		check(tokeq(js, toklarge, 4,
 					JSMN_ARRAY, -1, -1, 3,
@@ -226,14 +277,14 @@ int test_array_nomem(void) {
 int test_unquoted_keys(void) {
 #ifndef JSMN_STRICT
 	int r;
-	jsmn_parser p;
-	jsmntok_t tok[10];
+	jsmn_Parser p;
+	jsmn_Token tok[10];
 	const char *js;
 
-	jsmn_init(&p);
+	jsmn_parser_init(&p, tok, 10);
 	js = "key1: \"value\"\nkey2 : 123";
 
-	r = jsmn_parse(&p, js, strlen(js), tok, 10);
+	r = jsmn_parse(&p, js, strlen(js));
 	check(r >= 0);
 	check(tokeq(js, tok, 4,
 				JSMN_PRIMITIVE, "key1",
@@ -246,8 +297,8 @@ int test_unquoted_keys(void) {
 
 int test_issue_22(void) {
 	int r;
-	jsmn_parser p;
-	jsmntok_t tokens[128];
+	jsmn_Parser p;
+	jsmn_Token tokens[128];
 	const char *js;
 
 	js = "{ \"height\":10, \"layers\":[ { \"data\":[6,6], \"height\":10, "
@@ -258,8 +309,8 @@ int test_issue_22(void) {
 		"\"imageheight\":64, \"imagewidth\":160, \"margin\":0, \"name\":\"Tiles\", "
 		"\"properties\":{}, \"spacing\":0, \"tileheight\":32, \"tilewidth\":32 }], "
 		"\"tilewidth\":32, \"version\":1, \"width\":10 }";
-	jsmn_init(&p);
-	r = jsmn_parse(&p, js, strlen(js), tokens, 128);
+	jsmn_parser_init(&p, tokens, 128);
+	r = jsmn_parse(&p, js, strlen(js));
 	check(r >= 0);
 	return 0;
 }
@@ -274,65 +325,93 @@ int test_issue_27(void) {
 int test_input_length(void) {
 	const char *js;
 	int r;
-	jsmn_parser p;
-	jsmntok_t tokens[10];
+	jsmn_Parser p;
+	jsmn_Token tokens[10];
 
 	js = "{\"a\": 0}garbage";
 
-	jsmn_init(&p);
-	r = jsmn_parse(&p, js, 8, tokens, 10);
+	jsmn_parser_init(&p, tokens, 10);
+	r = jsmn_parse(&p, js, 8);
 	check(r == 3);
 	check(tokeq(js, tokens, 3,
 				JSMN_OBJECT, -1, -1, 1,
-				JSMN_STRING, "a", 1,
+				JSMN_LABEL, "a", 1,
 				JSMN_PRIMITIVE, "0"));
 	return 0;
 }
 
 int test_count(void) {
-	jsmn_parser p;
+	jsmn_Parser p;
 	const char *js;
 
 	js = "{}";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 1);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 1);
 
 	js = "[]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 1);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 1);
 
 	js = "[[]]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 2);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 2);
 
 	js = "[[], []]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 3);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 3);
 
 	js = "[[], []]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 3);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 3);
 
 	js = "[[], [[]], [[], []]]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 7);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 7);
 
 	js = "[\"a\", [[], []]]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 5);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 5);
 
 	js = "[[], \"[], [[]]\", [[]]]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 5);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 5);
 
 	js = "[1, 2, 3]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 4);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 4);
 
 	js = "[1, 2, [3, \"a\"], null]";
-	jsmn_init(&p);
-	check(jsmn_parse(&p, js, strlen(js), NULL, 0) == 7);
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 7);
+
+	/* Strings, escapes and primitives across blocks of 64 bytes */
+	js = "[\"a long string with [brackets], {braces} and \\\"quotes\\\" "
+		"going on and on\", -1.5e3, true, {\"key\": [null, \"\\\\\"], "
+		"\"x\": \"\\u00e9\"}, 1234567890123456789, \"\", [\"]\"]]";
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, strlen(js)) == 15);
 
+	/* Cut off data is counted by the parser */
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse(&p, js, 70) == JSMN_ERROR_PART);
+
+	/* Invalid primitives across and after blocks of 64 bytes */
+	js = "[\"a string filling most of the first block of 64 bytes.\", 1, "
+		"[tru, 2]]";
+	jsmn_parser_init(&p, NULL, 0);
+#ifdef JSMN_STRICT
+	check(jsmn_parse(&p, js, strlen(js)) == JSMN_ERROR_INVAL);
+#else
+	check(jsmn_parse(&p, js, strlen(js)) == 6);
+#endif
+	js = "[\"a string filling most of the first block of 64 bytes.\", 1, "
+		"[true, 2], 01]";
+	jsmn_parser_init(&p, NULL, 0);
+#ifdef JSMN_STRICT
+	check(jsmn_parse(&p, js, strlen(js)) == JSMN_ERROR_INVAL);
+#else
+	check(jsmn_parse(&p, js, strlen(js)) == 7);
+#endif
 	return 0;
 }
 
@@ -378,10 +457,1346 @@ int test_unmatched_brackets(void) {
 	js = "{\"key {1\": 1234}";
 	check(parse(js, 3, 3,
 				JSMN_OBJECT, 0, 16, 1,
-				JSMN_STRING, "key {1", 1,
+				JSMN_LABEL, "key {1", 1,
 				JSMN_PRIMITIVE, "1234"));
 	js = "{{\"key 1\": 1234}";
+#ifdef JSMN_STRICT
+	check(parse(js, JSMN_ERROR_INVAL, 4));
+#else
 	check(parse(js, JSMN_ERROR_PART, 4));
+#endif
+	return 0;
+}
+
+static int grow_calls = 0;
+
+static jsmn_Token *grow_tokens(void *ctx, jsmn_Token *toks, size_t len) {
+	grow_calls++;
+	if (ctx != NULL && len > *(size_t *)ctx) {
+		return NULL;
+	}
+	return realloc(toks, len * sizeof(*toks));
+}
+
+static void free_tokens(void *ctx, jsmn_Token *toks) {
+	free(toks);
+}
+
+int test_alloc(void) {
+	int i;
+	int r;
+	size_t limit = 64;
+	jsmn_Parser p;
+	jsmn_Factory f;
+	jsmn_Allocator alloc = { grow_tokens, free_tokens, NULL };
+	const char *kv = "k\0" "1";
+	char js[1024] = "[";
+
+	for (i = 0; i < 100; i++) {
+		strcat(js, i == 0 ? "\"x\"" : ", \"x\"");
+	}
+	strcat(js, "]");
+
+	grow_calls = 0;
+	jsmn_parser_init_alloc(&p, &alloc);
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == 101);
+	check(p.factory.tokslen >= 101);
+	check(grow_calls == 4);
+	check(p.factory.toks[0].type == JSMN_ARRAY);
+	check(p.factory.toks[0].size == 100);
+#ifdef JSMN_PARENT_LINKS
+	check(p.factory.toks[100].parent == 0);
+#endif
+	jsmn_factory_free(&p.factory);
+	check(p.factory.toks == NULL);
+
+	/* Allocator running out of memory */
+	alloc.ctx = &limit;
+	jsmn_parser_init_alloc(&p, &alloc);
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == JSMN_ERROR_NOMEM);
+	check(p.factory.toknext == 64);
+	jsmn_factory_free(&p.factory);
+
+	/* Builder */
+	alloc.ctx = NULL;
+	jsmn_factory_init_alloc(&f, &alloc);
+#ifdef JSMN_COMPACT_TOKENS
+	f.base = kv;
+#endif
+	check(jsmn_start_object(&f, NULL) > 0);
+	for (i = 0; i < 50; i++) {
+		check(jsmn_append_primitive(&f, kv, kv + 2) > 0);
+	}
+	check(jsmn_end_object(&f) == 101);
+	check(f.toks[0].size == 50);
+#ifdef JSMN_PARENT_LINKS
+	check(f.toks[100].parent == 99);
+#endif
+	jsmn_factory_free(&f);
+	return 0;
+}
+
+int test_stream(void) {
+	int i;
+	int r;
+	int seen = 0;
+	size_t n = 0;
+	size_t off = 0;
+	char win[24];
+	char out[256] = "";
+	jsmn_Parser p;
+	jsmn_Token tok[8];
+	jsmn_Token all[16];
+	const char *js = "[{\"a\": \"first\"}, {\"b\": [\"sec\\\"ond\", 2]}, "
+		"[1, 2, {\"c\": true}], \"x\\u0041\", {}]";
+
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	while (off < strlen(js)) {
+		/* Append the next chunk of 5 bytes to the window */
+		for (i = 0; i < 5 && js[off] != '\0'; i++) {
+			check(n < sizeof(win));
+			win[n++] = js[off++];
+		}
+		r = jsmn_stream_parse(&p, win, n);
+		if (off == strlen(js)) {
+			check(r >= 0);
+		} else {
+			check(r == JSMN_ERROR_PART);
+		}
+		/* Collect the new strings and primitives */
+		for (i = seen; i < p.factory.toknext; i++) {
+			if (tok[i].type >= JSMN_LABEL) {
+				strncat(out, win + (tok[i].start - p.base), tok[i].length);
+				strcat(out, "|");
+			}
+		}
+		r = jsmn_stream_release(&p);
+		memmove(win, win + r, n - r);
+		n -= r;
+		seen = p.factory.toknext;
+	}
+	check(strcmp(out, "a|first|b|sec\\\"ond|2|1|2|c|true|x\\u0041|") == 0);
+	check(p.factory.toknext == 0);
+	check(p.base == strlen(js));
+
+	/* Released anywhere, also between a key and its colon */
+	js = "{\"a\" : {\"bc\": [1, {\"d\" :\"e\"}]}, \"f\": 2}";
+	for (i = 1; i < strlen(js); i++) {
+		jsmn_parser_init(&p, all, sizeof(all)/sizeof(all[0]));
+		check(jsmn_stream_parse(&p, js, i) == JSMN_ERROR_PART);
+		n = jsmn_stream_release(&p);
+		check(jsmn_stream_parse(&p, js + n, strlen(js) - n) >= 0);
+		check(p.factory.depth == 0 && all[0].size == 2);
+		check(all[0].start == 0 && all[0].length == strlen(js));
+	}
+	return 0;
+}
+
+int test_records(void) {
+	int r;
+	jsmn_Parser p;
+	jsmn_Token tok[16];
+	jsmn_Record rec[8];
+	const char *js = "{\"a\": 1}\n[1, 2]\n\n{\"b\": 1]\n\"s\" 42\r\n{}{}\n{\"c\"";
+
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	r = jsmn_parse_records(&p, js, strlen(js), rec, 8);
+	check(r == 8);
+	check(p.factory.toknext == 10);
+	check(rec[0].error == 0 && rec[0].token == 0 && rec[0].count == 3);
+	check(rec[0].start == 0 && rec[0].length == 8);
+	check(rec[1].error == 0 && rec[1].token == 3 && rec[1].count == 3);
+	check(rec[1].start == 9 && rec[1].length == 6);
+	/* The failed line has no tokens, the next line goes on */
+	check(rec[2].error == JSMN_ERROR_INVAL && rec[2].count == 0);
+	check(rec[2].start == 17 && rec[2].length == 8);
+	check(rec[3].error == 0 && rec[3].token == 6 && rec[3].count == 1);
+	check(rec[3].start == 26 && rec[3].length == 3);
+	check(tok[6].type == JSMN_STRING);
+	check(rec[4].token == 7 && rec[4].start == 30 && rec[4].length == 2);
+	check(rec[5].token == 8 && rec[5].start == 34 && rec[5].length == 2);
+	check(rec[6].token == 9 && rec[6].start == 36 && rec[6].length == 2);
+	check(rec[7].error == JSMN_ERROR_PART && rec[7].token == 10);
+	check(rec[7].start == 39 && rec[7].length == 4);
+
+	/* A full table stops before the line which does not fit */
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	r = jsmn_parse_records(&p, js, strlen(js), rec, 4);
+	check(r == 3);
+	check(p.pos == 26 && p.factory.toknext == 6);
+	r = jsmn_parse_records(&p, js, strlen(js), rec, 1);
+	check(r == JSMN_ERROR_NOMEM);
+	r = jsmn_parse_records(&p, js, strlen(js), rec, 8);
+	check(r == 5);
+	check(rec[0].token == 6 && rec[1].token == 7);
+	check(rec[4].error == JSMN_ERROR_PART);
+
+	/* The end of the data ends a primitive on the last line */
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	r = jsmn_parse_records(&p, "[1]\n42", 6, rec, 8);
+	check(r == 2);
+	check(rec[1].error == 0 && rec[1].token == 2 && rec[1].count == 1);
+	check(rec[1].start == 4 && rec[1].length == 2);
+	check(jsmn_primitive_kind(&tok[2]) == JSMN_KIND_INTEGER);
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	r = jsmn_parse_records(&p, "tru", 3, rec, 8);
+	check(r == 1);
+#ifdef JSMN_STRICT
+	check(rec[0].error == JSMN_ERROR_INVAL);
+#else
+	check(rec[0].error == 0);
+#endif
+
+	/* A failed record ends before the line break, LF or CRLF */
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	r = jsmn_parse_records(&p, "[1]\r\n{\"b\": 1]\r\n[2]\r\n", 20, rec, 8);
+	check(r == 3);
+	check(rec[0].error == 0 && rec[0].start == 0 && rec[0].length == 3);
+	check(rec[1].error == JSMN_ERROR_INVAL);
+	check(rec[1].start == 5 && rec[1].length == 8);
+	check(rec[2].error == 0 && rec[2].start == 15 && rec[2].length == 3);
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	r = jsmn_parse_records(&p, "{\"b\": 1]\r", 9, rec, 8);
+	check(r == 1 && rec[0].error == JSMN_ERROR_INVAL);
+	check(rec[0].start == 0 && rec[0].length == 8);
+
+	jsmn_parser_init(&p, NULL, 0);
+	check(jsmn_parse_records(&p, js, strlen(js), rec, 8) == JSMN_ERROR_NOMEM);
+	return 0;
+}
+
+#ifdef JSMN_MMAP
+int test_file(void) {
+	int fd;
+	int r;
+	char path[] = "/tmp/jsmn-test-XXXXXX";
+	const char *js = "{\"a\": [1, \"b\"]}\n";
+	jsmn_Allocator alloc = { grow_tokens, free_tokens, NULL };
+	jsmn_File f;
+
+	fd = mkstemp(path);
+	check(fd >= 0);
+	check(write(fd, js, strlen(js)) == (ssize_t)strlen(js));
+	r = jsmn_parse_file(&f, path, &alloc);
+	check(r == 5);
+	check(f.len == strlen(js) && memcmp(f.js, js, f.len) == 0);
+	check(tokeq(f.js, f.parser.factory.toks, 5,
+				JSMN_OBJECT, 0, 15, 1,
+				JSMN_LABEL, "a", 1,
+				JSMN_ARRAY, 6, 14, 2,
+				JSMN_PRIMITIVE, "1",
+				JSMN_STRING, "b", 0));
+	jsmn_file_close(&f);
+	check(f.js == NULL && f.parser.factory.toks == NULL);
+
+	/* An empty file has no tokens */
+	check(ftruncate(fd, 0) == 0);
+	r = jsmn_parse_fd(&f, fd, &alloc);
+	check(r == 0 && f.len == 0);
+	jsmn_file_close(&f);
+
+	/* A file beyond the 32 bit offsets is not mapped, the file is sparse */
+	if (ftruncate(fd, (off_t)UINT_MAX + 1) == 0) {
+		r = jsmn_parse_fd(&f, fd, &alloc);
+		check(r == JSMN_ERROR_IO && f.js == NULL);
+		jsmn_file_close(&f);
+	}
+	close(fd);
+	unlink(path);
+
+	r = jsmn_parse_file(&f, path, &alloc);
+	check(r == JSMN_ERROR_IO);
+	jsmn_file_close(&f);
+	return 0;
+}
+#endif
+
+#ifdef JSMN_THREADS
+/* Allocator called by several threads at once */
+static jsmn_Token *grow_shared(void *ctx, jsmn_Token *toks, size_t len) {
+	return realloc(toks, len * sizeof(*toks));
+}
+
+struct parallel {
+	unsigned int next; /* offset expected for the next record */
+	int records;
+	int failed;
+	int stop; /* stop after so many records */
+};
+
+static int parallel_cb(void *ctx, const char *js, const jsmn_Token *toks,
+		const jsmn_Record *records, int count) {
+	struct parallel *par = ctx;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		/* Every line of the input is one record, in input order */
+		if (records[i].start != par->next) {
+			return -100;
+		}
+		par->next = records[i].start + records[i].length + 1;
+		if (records[i].error != 0) {
+			par->failed++;
+		} else if (toks[records[i].token].type != JSMN_OBJECT ||
+				toks[records[i].token].start != records[i].start) {
+			return -101;
+		}
+	}
+	par->records += count;
+	return par->stop > 0 && par->records >= par->stop ? -102 : 0;
+}
+
+int test_parallel(void) {
+	struct parallel par = { 0, 0, 0, 0 };
+	jsmn_Allocator alloc = { grow_shared, free_tokens, NULL };
+	size_t len = 0;
+	int lines = 0;
+	int r;
+	char *js = malloc(1024 * 1024);
+
+	check(js != NULL);
+	while (len < 1000 * 1000) {
+		if (lines % 1000 == 999) {
+			len += sprintf(js + len, "{\"broken\": %d]\n", lines);
+		} else {
+			len += sprintf(js + len, "{\"line\": %d, \"s\": \"x\\\"y\"}\n",
+					lines);
+		}
+		lines++;
+	}
+	r = jsmn_parse_parallel(js, len, 4, &alloc, parallel_cb, &par);
+	check(r == lines);
+	check(par.records == lines && par.next == len);
+	check(par.failed == lines / 1000);
+
+	/* The handler stops the parse */
+	memset(&par, 0, sizeof(par));
+	par.stop = 1;
+	r = jsmn_parse_parallel(js, len, 3, &alloc, parallel_cb, &par);
+	check(r == -102);
+	free(js);
+	return 0;
+}
+
+static int split_equal(const char *js, size_t len, unsigned int threads) {
+	jsmn_Allocator alloc = { grow_shared, free_tokens, NULL };
+	jsmn_Parser serial;
+	jsmn_Parser p;
+	int ok = 1;
+	int r;
+	int i;
+
+	jsmn_parser_init_alloc(&serial, &alloc);
+	jsmn_parser_init_alloc(&p, &alloc);
+	r = jsmn_parse(&serial, js, len);
+	if (jsmn_parse_split(&p, js, len, threads) != r) {
+		ok = 0;
+	}
+	for (i = 0; ok && r > 0 && i < r; i++) {
+		jsmn_Token *a = &serial.factory.toks[i];
+		jsmn_Token *b = &p.factory.toks[i];
+		if (a->type != b->type || a->flags != b->flags ||
+				a->start != b->start || a->length != b->length ||
+				a->size != b->size || a->next != b->next ||
+#ifdef JSMN_PARENT_LINKS
+				a->parent != b->parent ||
+#endif
+				jsmn_token_data(js, a) != jsmn_token_data(js, b)) {
+			printf("token %d differs\n", i);
+			ok = 0;
+		}
+	}
+	if (p.pos != serial.pos || p.factory.toksuper != serial.factory.toksuper) {
+		ok = 0;
+	}
+	jsmn_factory_free(&serial.factory);
+	jsmn_factory_free(&p.factory);
+	return ok;
+}
+
+int test_split(void) {
+	size_t len = 0;
+	size_t mid;
+	int i = 0;
+	char *js = malloc(2 * 1024 * 1024);
+	jsmn_Split split;
+	jsmn_Task tasks[4];
+	jsmn_Parser p;
+
+	check(js != NULL);
+	/* Strings full of commas, quotes and brackets across the chunks */
+	len += sprintf(js + len, "{\"list\": [");
+	while (len < 1024 * 1024) {
+		len += sprintf(js + len, "%s{\"id\": %d, \"s\": \"a, \\\"b\\\", "
+				"[c], {d}\\\\\", \"n\": [%d.5, true, null, {\"x\": [[]]}], "
+				"\"e\": \"\\u00e4, \\\"\", \"k\": {\"deep\": {\"er\": "
+				"\",\\\\\"}}}", i > 0 ? ",\n" : "", i, i);
+		i++;
+	}
+	len += sprintf(js + len, "], \"end\": \"x,\\\"y\"}");
+	check(split_equal(js, len, 2));
+	check(split_equal(js, len, 3));
+	check(split_equal(js, len, 4));
+	check(split_equal(js, len, 7));
+
+	/* The chunks are parsed on their own and joined */
+	split.js = js;
+	split.n = 4;
+	split.chunks = calloc(4, sizeof(*split.chunks));
+	check(split.chunks != NULL);
+	check(jsmn_split_chunks(&split, tasks, len) == 4);
+	jsmn_parser_init_alloc(&p, &jsmn_heap);
+	check(jsmn_split_parse_all(&p, &split, tasks) > 0);
+	for (i = 0; i < 4; i++) {
+		jsmn_factory_free(&split.chunks[i].parser.factory);
+	}
+	jsmn_factory_free(&p.factory);
+	free(split.chunks);
+
+	/* Invalid data gives the error of the serial parse */
+	mid = len / 2;
+	while (js[mid] != ',') {
+		mid++;
+	}
+	js[mid] = ']';
+	check(split_equal(js, len, 4));
+	js[mid] = ',';
+	check(split_equal(js, len - 1, 4));
+	check(split_equal(js, mid, 4));
+
+	/* Numbers only, all chunks start within the same array */
+	len = 0;
+	js[len++] = '[';
+	for (i = 0; len < 1024 * 1024; i++) {
+		len += sprintf(js + len, "%d, ", i);
+	}
+	len += sprintf(js + len, "-1]");
+	check(split_equal(js, len, 4));
+	free(js);
+	return 0;
+}
+#endif
+
+int test_depth(void) {
+	int i;
+	int r;
+	int n = 3 * JSMN_MAX_DEPTH;
+	int len;
+	char *deep;
+	char *obj;
+	jsmn_Parser p;
+	jsmn_Factory f;
+	jsmn_Allocator alloc = { grow_tokens, free_tokens, NULL };
+	jsmn_Token *tok;
+
+	deep = malloc(2 * n + 1);
+	obj = malloc(6 * n + 2);
+	tok = malloc((2 * n + 1) * sizeof(*tok));
+	for (i = 0; i < n; i++) {
+		deep[i] = '[';
+		deep[2 * n - 1 - i] = ']';
+	}
+	deep[2 * n] = '\0';
+
+	/* Deeper than the stack with a fixed token array */
+	jsmn_parser_init(&p, tok, n);
+	r = jsmn_parse(&p, deep, 2 * n);
+	check(r == n);
+	check(tok[0].length == 2 * n);
+	check(tok[n - 1].length == 2);
+	check(tok[JSMN_MAX_DEPTH].length == 2 * (n - JSMN_MAX_DEPTH));
+	check(tok[JSMN_MAX_DEPTH].next == n);
+#ifdef JSMN_PARENT_LINKS
+	check(tok[n - 1].parent == n - 2);
+#endif
+	deep[n + 1] = '}';
+	jsmn_parser_init(&p, tok, n);
+	check(jsmn_parse(&p, deep, 2 * n) == JSMN_ERROR_INVAL);
+	deep[n + 1] = ']';
+
+	/* With an allocator */
+	jsmn_parser_init_alloc(&p, &alloc);
+	r = jsmn_parse(&p, deep, 2 * n);
+	check(r == n);
+	check(p.factory.toks[0].length == 2 * n);
+#ifdef JSMN_PARENT_LINKS
+	check(p.factory.toks[n - 1].parent == n - 2);
+#endif
+	jsmn_factory_free(&p.factory);
+
+	/* Streamed, the open arrays are kept */
+	jsmn_parser_init_alloc(&p, &alloc);
+	check(jsmn_stream_parse(&p, deep, n) == JSMN_ERROR_PART);
+	check(jsmn_stream_release(&p) == (size_t)n);
+	check(p.factory.toknext == n);
+	check(jsmn_stream_parse(&p, deep + n, n) == n);
+	check(p.factory.toks[0].length == 2 * n);
+	check(p.factory.toks[n - 1].length == 2);
+	jsmn_factory_free(&p.factory);
+
+	/* Objects, whose values follow their labels */
+	len = 0;
+	for (i = 0; i < n; i++) {
+		len += sprintf(obj + len, "{\"a\":");
+	}
+	obj[len++] = '1';
+	for (i = 0; i < n; i++) {
+		obj[len++] = '}';
+	}
+	obj[len] = '\0';
+	jsmn_parser_init(&p, tok, 2 * n + 1);
+	check(jsmn_parse(&p, obj, len) == 2 * n + 1);
+	check(tok[2 * JSMN_MAX_DEPTH].next == 2 * n + 1);
+	check(tok[2 * JSMN_MAX_DEPTH + 1].next == 2 * n + 1);
+	check(tok[2 * n - 2].length == 7);
+	jsmn_parser_init(&p, tok, 2 * n + 1);
+	check(jsmn_stream_parse(&p, obj, 5 * (n / 2)) == JSMN_ERROR_PART);
+	r = jsmn_stream_release(&p);
+	check(jsmn_stream_parse(&p, obj + r, len - r) >= 0);
+	check(p.factory.depth == 0);
+	check(tok[0].type == JSMN_OBJECT && tok[0].length == len);
+	check(tok[1].type == JSMN_LABEL && tok[1].next == p.factory.toknext);
+
+	/* Builder without an allocator */
+	jsmn_factory_init(&f, tok, n);
+	for (i = 0; i < n; i++) {
+		check(jsmn_start_array(&f, NULL) == i + 1);
+	}
+	check(jsmn_end_object(&f) == JSMN_ERROR_FACTORY);
+	for (i = 0; i < n; i++) {
+		check(jsmn_end_array(&f) == n);
+	}
+	check(jsmn_end_array(&f) == JSMN_ERROR_FACTORY);
+	check(tok[0].next == n);
+	check(tok[n - 1].next == n);
+	check(tok[JSMN_MAX_DEPTH].length == -1);
+	free(tok);
+	free(obj);
+	free(deep);
+	return 0;
+}
+
+int test_block_boundaries(void) {
+	int i;
+	int r;
+	jsmn_Parser p;
+	jsmn_Token tok[10];
+	const char *js = "{\"a\":                                                   "
+		"\"a string that runs across several blocks of the index with an "
+		"escaped \\\" quote and a \\u00e4 code point at its end\", \"b\": "
+		"[                                                                 "
+		"12345678901234567890123456789012345678901234567890123456789012345"
+		"                                                                ]}";
+
+	check(parse(js, 6, 6,
+				JSMN_OBJECT, -1, -1, 2,
+				JSMN_LABEL, "a", 1,
+				JSMN_STRING, "a string that runs across several blocks of the "
+				"index with an escaped \\\" quote and a \\u00e4 code point at "
+				"its end", 0,
+				JSMN_LABEL, "b", 1,
+				JSMN_ARRAY, -1, -1, 1,
+				JSMN_PRIMITIVE, NULL));
+
+	jsmn_parser_init(&p, tok, sizeof(tok)/sizeof(tok[0]));
+	for (i = 1; i <= strlen(js); i++) {
+		r = jsmn_parse(&p, js, i);
+		if (i == strlen(js)) {
+			check(r == 6);
+			check(tokeq(js, tok, 6,
+						JSMN_OBJECT, -1, -1, 2,
+						JSMN_LABEL, "a", 1,
+						JSMN_STRING, NULL, 0,
+						JSMN_LABEL, "b", 1,
+						JSMN_ARRAY, -1, -1, 1,
+						JSMN_PRIMITIVE, "123456789012345678901234567890123456"
+						"78901234567890123456789012345"));
+		} else {
+			check(r == JSMN_ERROR_PART);
+		}
+	}
+	return 0;
+}
+
+static char dumped[256];
+
+static int dump_cb(const char *data, size_t length) {
+	strncat(dumped, data, length);
+	return 0;
+}
+
+static char *collected;
+static size_t collectedlen;
+
+static int collect_cb(const char *data, size_t length) {
+	memcpy(collected + collectedlen, data, length);
+	collectedlen += length;
+	return 0;
+}
+
+int test_token_data(void) {
+	int r;
+	jsmn_Parser p;
+	jsmn_Factory f;
+	jsmn_Token t[8];
+	const char *js = "{\"a\": [1, \"b\"]}";
+	const char *names = "x\0" "true\0" "str";
+
+#if defined(JSMN_COMPACT_TOKENS) && defined(JSMN_PARENT_LINKS)
+	check(sizeof(jsmn_Token) == 20);
+#elif defined(JSMN_COMPACT_TOKENS)
+	check(sizeof(jsmn_Token) == 16);
+#endif
+	jsmn_parser_init(&p, t, 8);
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == 5);
+	check(strncmp(jsmn_token_data(js, &t[1]), "a", t[1].length) == 0);
+	check(strncmp(jsmn_token_data(js, &t[4]), "b", t[4].length) == 0);
+	dumped[0] = '\0';
+	check(jsmn_dump_js(js, t, dump_cb) == 5);
+	check(strcmp(dumped, "{\"a\":[1,\"b\"]}") == 0);
+#ifndef JSMN_COMPACT_TOKENS
+	dumped[0] = '\0';
+	check(jsmn_dump(t, dump_cb) == 5);
+	check(strcmp(dumped, "{\"a\":[1,\"b\"]}") == 0);
+#endif
+
+	jsmn_factory_init(&f, t, 8);
+#ifdef JSMN_COMPACT_TOKENS
+	/* The builders need a base for the offsets */
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_append_string(&f, names, names + 7) == JSMN_ERROR_FACTORY);
+	check(f.toknext == 1 && t[0].size == 0 && t[0].next == 1);
+	jsmn_factory_init(&f, t, 8);
+	f.base = names;
+#endif
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_append_primitive(&f, names, names + 2) > 0);
+	check(jsmn_append_string(&f, names, names + 7) > 0);
+	check(jsmn_end_object(&f) == 5);
+	check(strcmp(jsmn_token_data(names, &t[4]), "str") == 0);
+	dumped[0] = '\0';
+	check(jsmn_dump_js(names, t, dump_cb) == 5);
+	check(strcmp(dumped, "{\"x\":true,\"x\":\"str\"}") == 0);
+
+	/* A failed call leaves the factory unchanged */
+	jsmn_factory_init(&f, t, 2);
+#ifdef JSMN_COMPACT_TOKENS
+	f.base = names;
+#endif
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_append_string(&f, names, names + 7) == JSMN_ERROR_FACTORY);
+	check(jsmn_append_string(&f, NULL, names + 7) == JSMN_ERROR_FACTORY);
+	check(f.toknext == 1 && t[0].size == 0 && t[0].next == 1);
+	check(jsmn_end_object(&f) == 1);
+	dumped[0] = '\0';
+	check(jsmn_dump_js(names, t, dump_cb) == 1);
+	check(strcmp(dumped, "{}") == 0);
+	return 0;
+}
+
+int test_writer(void) {
+	int i;
+	int r;
+	jsmn_Parser p;
+	jsmn_Token t[8];
+	jsmn_Writer w;
+	jsmn_Writer mem;
+	char buf[64];
+	char small[4];
+	const char *js = "{\"a\": [1, \"bcdefgh\"], \"c\": {}}";
+	const char *out = "{\"a\":[1,\"bcdefgh\"],\"c\":{}}";
+	FILE *fp;
+
+	jsmn_parser_init(&p, t, 8);
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == 7);
+
+	/* Without sink the output stays in the buffer */
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_dump_writer(js, t, &w) == 7);
+	check(jsmn_writer_flush(&w) == 0);
+	check(w.len == strlen(out) && strncmp(buf, out, w.len) == 0);
+	jsmn_writer_init(&w, buf, 8, NULL, NULL);
+	check(jsmn_dump_writer(js, t, &w) == JSMN_ERROR_NOMEM);
+	check(jsmn_writer_write(&w, "x", 1) == JSMN_ERROR_NOMEM);
+
+	/* A small buffer is handed on in full blocks, larger data directly */
+	for (i = 1; i <= 4; i++) {
+		jsmn_writer_init(&mem, buf, sizeof(buf), NULL, NULL);
+		jsmn_writer_init(&w, small, i, jsmn_sink_memory, &mem);
+		check(jsmn_dump_writer(js, t, &w) == 7);
+		check(w.len <= (size_t)i);
+		check(jsmn_writer_flush(&w) == 0 && w.len == 0);
+		check(mem.len == strlen(out) && strncmp(buf, out, mem.len) == 0);
+	}
+	jsmn_writer_init(&mem, buf, 8, NULL, NULL);
+	jsmn_writer_init(&w, small, 4, jsmn_sink_memory, &mem);
+	check(jsmn_dump_writer(js, t, &w) == JSMN_ERROR_NOMEM);
+
+	fp = tmpfile();
+	check(fp != NULL);
+	jsmn_writer_init(&w, small, 4, jsmn_sink_file, fp);
+	check(jsmn_dump_writer(js, t, &w) == 7 && jsmn_writer_flush(&w) == 0);
+#ifdef JSMN_POSIX
+	{
+		int fd = fileno(fp);
+		fflush(fp);
+		jsmn_writer_init(&w, small, 4, jsmn_sink_fd, &fd);
+		check(jsmn_dump_writer(js, t, &w) == 7 && jsmn_writer_flush(&w) == 0);
+		fseek(fp, 0, SEEK_END);
+	}
+#endif
+	rewind(fp);
+	r = fread(buf, 1, sizeof(buf), fp);
+	fclose(fp);
+	check(r > 0 && r % strlen(out) == 0);
+	for (i = 0; i < r; i += strlen(out)) {
+		check(strncmp(buf + i, out, strlen(out)) == 0);
+	}
+	return 0;
+}
+
+int test_escape(void) {
+	int i;
+	int r;
+	jsmn_Parser p;
+	jsmn_Factory f;
+	jsmn_Token t[8];
+	jsmn_Writer w;
+	char buf[256];
+	char text[80];
+	char expect[256];
+	const char *js = "[\"a\\n\\\"\", \"\u00e4\"]";
+	const char *raw = "q\"b\\n\n\x01\x1f\x7f\xc3\xa4";
+
+	/* Strings of the parser are JSON already */
+	jsmn_parser_init(&p, t, 8);
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == 3);
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_dump_writer(js, t, &w) == 3);
+	check(w.len == strlen(js) - 1 && strncmp(buf, "[\"a\\n\\\"\",", 8) == 0);
+
+	/* Strings and labels of the builders are plain text */
+	jsmn_factory_init(&f, t, 8);
+#ifdef JSMN_COMPACT_TOKENS
+	f.base = raw;
+#endif
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_append_string(&f, raw, raw) > 0);
+	check(jsmn_end_object(&f) == 3);
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_dump_writer(raw, t, &w) == 3);
+	strcpy(expect, "\"q\\\"b\\\\n\\n\\u0001\\u001f\x7f\xc3\xa4\"");
+	check(w.len == 2 * strlen(expect) + 3);
+	check(strncmp(buf + 1, expect, strlen(expect)) == 0);
+	check(buf[strlen(expect) + 1] == ':');
+	/* Text known to be clean is copied as it is */
+	t[2].flags &= ~JSMN_FLAG_RAW;
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_dump_writer(raw, t, &w) == 3);
+	check(w.len == strlen(expect) + strlen(raw) + 5);
+
+	/* Special characters at every position of the SIMD blocks */
+	for (i = 0; i < 70; i++) {
+		memset(text, 'x', sizeof(text) - 1);
+		text[sizeof(text) - 1] = '\0';
+		text[i] = '\t';
+		text[i + 1] = (i % 3 == 0) ? '\"' : 'y';
+		jsmn_factory_init(&f, t, 8);
+#ifdef JSMN_COMPACT_TOKENS
+		f.base = text;
+#endif
+		check(jsmn_append_string(&f, NULL, text) > 0);
+		jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+		check(jsmn_dump_writer(text, t, &w) == 1);
+		check(w.len == strlen(text) + 3 + (i % 3 == 0));
+		check(buf[i + 1] == '\\' && buf[i + 2] == 't');
+		check(strncmp(buf + i + 3, (i % 3 == 0) ? "\\\"" : "y",
+					1 + (i % 3 == 0)) == 0);
+		check(memchr(buf, '\t', w.len) == NULL);
+	}
+	return 0;
+}
+
+int test_serialize(void) {
+	int i;
+	int r;
+	jsmn_Parser p;
+	jsmn_Token t[16];
+	jsmn_Writer w;
+	char buf[128];
+	const char *js = "{\"a\": [1, \"b\", {}, []], \"c\": {\"d\": [[null]]}, "
+		"\"e\": \"f\"}";
+	const char *pretty =
+		"{\n"
+		"  \"a\": [\n"
+		"    1,\n"
+		"    \"b\",\n"
+		"    {},\n"
+		"    []\n"
+		"  ],\n"
+		"  \"c\": {\n"
+		"    \"d\": [\n"
+		"      [\n"
+		"        null\n"
+		"      ]\n"
+		"    ]\n"
+		"  },\n"
+		"  \"e\": \"f\"\n"
+		"}";
+	int n;
+	int len;
+	size_t size;
+	char *deep;
+	char *out;
+	jsmn_Token *tok;
+
+	jsmn_parser_init(&p, t, sizeof(t)/sizeof(t[0]));
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == 15);
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_serialize(js, t, &w, 0) == 15);
+	check(w.len == 46);
+	check(strncmp(buf, "{\"a\":[1,\"b\",{},[]],\"c\":{\"d\":[[null]]},"
+				"\"e\":\"f\"}", w.len) == 0);
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_serialize(js, t, &w, 2) == 15);
+	check(w.len == strlen(pretty) && strncmp(buf, pretty, w.len) == 0);
+	/* Only the value 't' is written */
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_serialize(js, t + 10, &w, 0) == 3);
+	check(w.len == 8 && strncmp(buf, "[[null]]", 8) == 0);
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_serialize(js, t + 14, &w, 2) == 1);
+	check(w.len == 3 && strncmp(buf, "\"f\"", 3) == 0);
+
+	/* Deeper than the stack */
+	n = 3 * JSMN_MAX_DEPTH + 5;
+	deep = malloc(12 * n + 2);
+	size = 8 * n * (n + 16);
+	out = malloc(size);
+	tok = malloc(8 * n * sizeof(*tok));
+	len = 0;
+	for (i = 0; i < n; i++) {
+		len += sprintf(deep + len, i % 2 ? "{\"a\":" : "[1,");
+	}
+	deep[len++] = '0';
+	for (i = n - 1; i >= 0; i--) {
+		len += sprintf(deep + len, i % 2 ? ",\"b\":3}" : ",2]");
+	}
+	jsmn_parser_init(&p, tok, 4 * n);
+	r = jsmn_parse(&p, deep, len);
+	check(r > 0);
+	jsmn_writer_init(&w, out, size, NULL, NULL);
+	check(jsmn_serialize(deep, tok, &w, 0) == r);
+	check(w.len == len && memcmp(out, deep, len) == 0);
+	collected = out;
+	collectedlen = 0;
+	check(jsmn_dump_js(deep, tok, collect_cb) == r);
+	check(collectedlen == len && memcmp(out, deep, len) == 0);
+	/* A value within, nested deeper as well */
+	jsmn_writer_init(&w, out, size, NULL, NULL);
+	check(jsmn_serialize(deep, tok + 2, &w, 0) == r - 3);
+	check(w.len == len - 6 && memcmp(out, deep + 3, len - 6) == 0);
+	/* Indented, it parses to the same tokens */
+	jsmn_writer_init(&w, out, size, NULL, NULL);
+	check(jsmn_serialize(deep, tok, &w, 1) == r);
+	jsmn_parser_init(&p, tok + r, 8 * n - r);
+	check(jsmn_parse(&p, out, w.len) == r);
+	jsmn_writer_init(&w, out + w.len, size - w.len, NULL, NULL);
+	check(jsmn_serialize(out, tok + r, &w, 0) == r);
+	check(w.len == len && memcmp(w.buf, deep, len) == 0);
+	free(tok);
+	free(out);
+	free(deep);
+	return 0;
+}
+
+int test_append_numbers(void) {
+	int i;
+	int n;
+	jsmn_Factory f;
+	jsmn_Token t[24];
+	jsmn_Writer w;
+	char chars[256];
+	char buf[256];
+	char num[32];
+	const double doubles[] = { 0.1, 1.0, -0.0, 1e21, 1e22, 1.5e-6, 1e-7,
+		5e-324, 1.7976931348623157e308, 123456.789 };
+	const char *expect = "[0,-9223372036854775808,18446744073709551615,"
+		"0.1,1.0,-0.0,1e+21,1e+22,0.0000015,1e-7,5e-324,"
+		"1.7976931348623157e+308,123456.789,true,false,null]";
+
+	jsmn_factory_init(&f, t, 24);
+	jsmn_factory_storage(&f, chars, sizeof(chars));
+	check(jsmn_start_array(&f, NULL) > 0);
+	check(jsmn_append_int64(&f, NULL, 0) > 0);
+	check(jsmn_append_int64(&f, NULL, INT64_MIN) > 0);
+	check(jsmn_append_uint64(&f, NULL, UINT64_MAX) > 0);
+	for (i = 0; i < (int)(sizeof(doubles) / sizeof(doubles[0])); i++) {
+		check(jsmn_append_double(&f, NULL, doubles[i]) > 0);
+		check(jsmn_primitive_kind(&t[f.toknext - 1]) == JSMN_KIND_FLOAT);
+	}
+	check(jsmn_append_bool(&f, NULL, 1) > 0);
+	check(jsmn_append_bool(&f, NULL, 0) > 0);
+	check(jsmn_append_null(&f, NULL) > 0);
+	check(jsmn_end_array(&f) == 17);
+	check(jsmn_primitive_kind(&t[2]) == JSMN_KIND_INTEGER);
+	check(jsmn_primitive_kind(&t[16]) == JSMN_KIND_NULL);
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_serialize(chars, t, &w, 0) == 17);
+	check(w.len == strlen(expect) && strncmp(buf, expect, w.len) == 0);
+
+	/* Compact tokens refer to copies of names outside the storage */
+	jsmn_factory_init(&f, t, 24);
+	jsmn_factory_storage(&f, chars, sizeof(chars));
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_append_int64(&f, "key", 5) == 3);
+	/* A failed call does not take any characters */
+	n = f.charnext;
+	check(jsmn_append_int64(&f, NULL, 6) == JSMN_ERROR_FACTORY);
+	check(jsmn_append_double(&f, NULL, 0.5) == JSMN_ERROR_FACTORY);
+	check(jsmn_append_null(&f, NULL) == JSMN_ERROR_FACTORY);
+	check((int)f.charnext == n && f.toknext == 3);
+	check(jsmn_end_object(&f) == 3);
+#ifdef JSMN_COMPACT_TOKENS
+	check(f.charnext == 4);
+#else
+	check(f.charnext == 1);
+#endif
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_serialize(chars, t, &w, 0) == 3);
+	check(w.len == 9 && strncmp(buf, "{\"key\":5}", 9) == 0);
+
+	/* Infinity and NaN are not JSON, the storage is limited */
+	jsmn_factory_init(&f, t, 24);
+	jsmn_factory_storage(&f, chars, 20);
+	check(jsmn_append_double(&f, NULL, 1.0 / 0.0) == JSMN_ERROR_INVAL);
+	check(jsmn_append_double(&f, NULL, 0.0 / 0.0) == JSMN_ERROR_INVAL);
+	check(jsmn_append_double(&f, NULL, 1.0) == JSMN_ERROR_NOMEM);
+	check(jsmn_append_uint64(&f, NULL, 1) > 0);
+	check(jsmn_append_uint64(&f, NULL, 1) == JSMN_ERROR_NOMEM);
+
+	/* Every double reads back the same */
+	for (i = 0; i < 10000; i++) {
+		double d = (i * 7919.0 + 0.5) / (i % 97 + 1) * (i % 2 ? 1e-9 : 1e9);
+		jsmn_factory_init(&f, t, 24);
+		jsmn_factory_storage(&f, chars, sizeof(chars));
+		check(jsmn_append_double(&f, NULL, d) > 0);
+		n = t[0].length;
+		memcpy(num, jsmn_token_data(chars, &t[0]), n);
+		num[n] = '\0';
+		check(strtod(num, NULL) == d);
+	}
+	return 0;
+}
+
+int test_arena(void) {
+	int doc;
+	jsmn_Factory f;
+	jsmn_Token t[16];
+	jsmn_Writer w;
+	char arena[64];
+	char buf[128];
+	char src[32];
+	const char *expect = "{\"value\":{\"key\":\"\\\"q\\\"\"},"
+		"\"list\":[true,0]}";
+
+	jsmn_factory_init(&f, t, 16);
+	jsmn_factory_arena(&f, arena, sizeof(arena));
+	for (doc = 0; doc < 2; doc++) {
+		/* Names and values are slices of a buffer which is reused */
+		strcpy(src, "keyvalue\"q\"listtrue");
+		check(jsmn_start_object_len(&f, NULL, 0) > 0);
+		check(jsmn_start_object_len(&f, src + 3, 5) > 0);
+		check(jsmn_append_string_len(&f, src, 3, src + 8, 3) > 0);
+		check(jsmn_end_object(&f) > 0);
+		check(jsmn_start_array_len(&f, src + 11, 4) > 0);
+		check(jsmn_append_primitive_len(&f, NULL, 0, src + 15, 4) > 0);
+		check(jsmn_append_int64(&f, NULL, 0) > 0);
+		check(jsmn_end_array(&f) > 0);
+		check(jsmn_end_object(&f) == 9);
+		memset(src, 'x', sizeof(src));
+		check(f.charnext == 5 + 3 + 3 + 4 + 4 + 1);
+		check(jsmn_primitive_kind(&t[7]) == JSMN_KIND_TRUE);
+		jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+		check(jsmn_serialize(arena, t, &w, 0) == 9);
+		check(w.len == strlen(expect) && strncmp(buf, expect, w.len) == 0);
+		/* The next document starts from the beginning again */
+		jsmn_factory_reset(&f);
+		check(f.toknext == 0 && f.charnext == 0);
+	}
+
+	/* The builders fail when the arena is full */
+	jsmn_factory_arena(&f, arena, 4);
+	check(jsmn_start_array(&f, NULL) > 0);
+	check(jsmn_append_string(&f, NULL, "abc") > 0);
+	check(jsmn_append_string(&f, NULL, "de") == JSMN_ERROR_NOMEM);
+	check(jsmn_append_string_len(&f, NULL, 0, "d", 1) > 0);
+	check(jsmn_end_array(&f) == 3);
+	jsmn_factory_reset(&f);
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_append_null(&f, "names") == JSMN_ERROR_NOMEM);
+	/* A failed call gives the copies back */
+	check(jsmn_append_string_len(&f, NULL, 0, "abc", 3) == JSMN_ERROR_FACTORY);
+	check(f.charnext == 0 && f.toknext == 1);
+
+	/* Numbers and literals with names of a given length */
+	strcpy(src, "abcd");
+	jsmn_factory_arena(&f, arena, sizeof(arena));
+	jsmn_factory_reset(&f);
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_append_int64_len(&f, src, 1, -1) > 0);
+	check(jsmn_append_uint64_len(&f, src + 1, 1, 2) > 0);
+	check(jsmn_append_double_len(&f, src + 2, 1, 0.5) > 0);
+	check(jsmn_append_bool_len(&f, src + 3, 1, 1) > 0);
+	check(jsmn_append_null_len(&f, src, 2) > 0);
+	check(jsmn_end_object(&f) == 11);
+	memset(src, 'x', sizeof(src));
+	jsmn_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+	check(jsmn_serialize(arena, t, &w, 0) == 11);
+	check(w.len == 41 && strncmp(buf, "{\"a\":-1,\"b\":2,\"c\":0.5,"
+				"\"d\":true,\"ab\":null}", 41) == 0);
+	return 0;
+}
+
+int test_subtree(void) {
+	int i;
+	int r;
+	jsmn_Parser p;
+	jsmn_Factory f;
+	jsmn_Token t[16];
+	const char *js = "{\"a\": {\"b\": [1, 2]}, \"c\": 3, \"d\": [[], {}]}";
+	const char *names = "a\0" "b\0" "1";
+	int next[] = { 13, 7, 7, 7, 7, 6, 7, 9, 9, 13, 13, 12, 13 };
+
+	jsmn_parser_init(&p, t, 16);
+	r = jsmn_parse(&p, js, strlen(js));
+	check(r == 13);
+	for (i = 0; i < r; i++) {
+		check(t[i].next == next[i]);
+	}
+	/* Iterate the members of the root object */
+	for (i = 1, r = 0; i < t[0].next; i = t[i].next) {
+		check(t[i].type == JSMN_LABEL);
+		r++;
+	}
+	check(r == t[0].size);
+
+	/* Continue after the open objects */
+	jsmn_parser_init(&p, t, 16);
+	check(jsmn_parse(&p, js, 10) == JSMN_ERROR_PART);
+	check(t[2].next == 4 && t[3].next == 4);
+	check(jsmn_parse(&p, js, strlen(js)) == 13);
+	for (i = 0; i < 13; i++) {
+		check(t[i].next == next[i]);
+	}
+
+	jsmn_factory_init(&f, t, 16);
+#ifdef JSMN_COMPACT_TOKENS
+	f.base = names;
+#endif
+	check(jsmn_start_object(&f, NULL) > 0);
+	check(jsmn_start_array(&f, names) > 0);
+	check(jsmn_append_primitive(&f, NULL, names + 4) > 0);
+	check(jsmn_end_array(&f) > 0);
+	check(jsmn_append_primitive(&f, names + 2, names + 4) > 0);
+	check(jsmn_end_object(&f) == 6);
+	check(t[0].next == 6 && t[1].next == 4 && t[2].next == 4);
+	check(t[3].next == 4 && t[4].next == 6 && t[5].next == 6);
+
+	/* Nested arrays continue with the enclosing array */
+	jsmn_factory_init(&f, t, 16);
+#ifdef JSMN_COMPACT_TOKENS
+	f.base = names;
+#endif
+	check(jsmn_start_array(&f, NULL) > 0);
+	check(jsmn_start_array(&f, NULL) > 0);
+	check(jsmn_end_array(&f) > 0);
+	check(jsmn_append_primitive(&f, NULL, names + 4) > 0);
+	check(jsmn_end_array(&f) == 3);
+	check(t[0].size == 2 && t[1].size == 0);
+	check(t[0].next == 3 && t[1].next == 2);
+	return 0;
+}
+
+int test_lookup(void) {
+	int i;
+	int r;
+	int n;
+	jsmn_Parser p;
+	jsmn_Lookup l;
+	jsmn_Token t[128];
+	int slots[128];
+	char key[8];
+	char js[1024] = "{";
+
+	for (i = 0; i < 40; i++) {
+		sprintf(js + strlen(js), "%s\"k%d\": %d", i == 0 ? "" : ", ", i, i);
+	}
+	strcat(js, ", \"k7\": 0, \"o\": {\"a\": 1, \"b\\n\": [2]}}");
+	jsmn_parser_init(&p, t, 128);
+	n = jsmn_parse(&p, js, strlen(js));
+	check(n == 90);
+
+	jsmn_lookup_init(&l, slots, 128);
+	for (r = 0; r < 2; r++) {
+		for (i = 0; i < 40; i++) {
+			sprintf(key, "k%d", i);
+			check(jsmn_lookup(&l, js, t, 0, key, strlen(key)) == 2 * i + 2);
+			check(jsmn_lookup(NULL, js, t, 0, key, strlen(key)) == 2 * i + 2);
+		}
+	}
+	check(l.count == 1);
+	check(jsmn_lookup(&l, js, t, 0, "k40", 3) == 0);
+	check(jsmn_lookup(&l, js, t, 0, "k", 1) == 0);
+	check(jsmn_lookup(&l, js, t, 0, "o", 1) == 84);
+	/* Small objects are not indexed, keys are not decoded */
+	check(jsmn_lookup(&l, js, t, 84, "b\\n", 3) == 88);
+	check(jsmn_lookup(&l, js, t, 84, "b\n", 2) == 0);
+	check(l.count == 1);
+	check(jsmn_lookup(&l, js, t, 86, "a", 1) == JSMN_ERROR_INVAL);
+
+	/* Without enough slots the object is searched linearly */
+	jsmn_lookup_init(&l, slots, 64);
+	check(jsmn_lookup(&l, js, t, 0, "k39", 3) == 80);
+	check(jsmn_lookup(&l, js, t, 0, "k7", 2) == 16);
+	check(l.count == 0);
+	return 0;
+}
+
+int test_match(void) {
+	int r;
+	jsmn_Parser p;
+	jsmn_Matcher m;
+	jsmn_Token t[64];
+	jsmn_Match res[16];
+	const char *js = "{\"meta\": {\"host\": \"h\", \"a/b\": 1, \"m~n\": 2}, "
+		"\"events\": [{\"ts\": 10}, {\"id\": 0}, {\"ts\": 12}], "
+		"\"1\": true}";
+	const char *paths[] = { "/meta/host", "/events/*/ts", "/events/1",
+		"/meta/a~1b", "/meta/m~0n", "/1", "", "/none/*" };
+	const char *invalid[] = { "meta", "/a~2", "/a~" };
+
+	jsmn_parser_init(&p, t, 64);
+	check(jsmn_parse(&p, js, strlen(js)) == 22);
+	check(jsmn_matcher_compile(&m, paths, 8) == 0);
+	r = jsmn_match(&m, js, t, 0, res, 16);
+	check(r == 8);
+	check(res[0].path == 6 && res[0].token == 0);
+	check(res[1].path == 0 && res[1].token == 4);
+	check(res[2].path == 3 && res[2].token == 6);
+	check(res[3].path == 4 && res[3].token == 8);
+	check(res[4].path == 1 && res[4].token == 13);
+	check(res[5].path == 2 && res[5].token == 14);
+	check(res[6].path == 1 && res[6].token == 19);
+	check(res[7].path == 5 && res[7].token == 21);
+	check(jsmn_match(&m, js, t, 0, res, 7) == JSMN_ERROR_NOMEM);
+	/* Match within a subtree */
+	check(jsmn_match(&m, js, t, 2, res, 16) == 1);
+	check(res[0].path == 6 && res[0].token == 2);
+
+	check(jsmn_matcher_compile(&m, &invalid[0], 1) == JSMN_ERROR_INVAL);
+	check(jsmn_matcher_compile(&m, &invalid[1], 1) == JSMN_ERROR_INVAL);
+	check(jsmn_matcher_compile(&m, &invalid[2], 1) == JSMN_ERROR_INVAL);
+	return 0;
+}
+
+int test_projection(void) {
+	int r;
+	jsmn_Parser p;
+	jsmn_Matcher m;
+	jsmn_Token t[32];
+	jsmn_Match res[8];
+	const char *js = "{\"meta\": {\"host\": \"h\", \"skip\": [1, {\"x\": \"}]\"}]}, "
+		"\"events\": [{\"ts\": 10, \"id\": 1}, [], {\"ts\": {\"s\": 12}}], "
+		"\"big\": [[[\"\\\"[\"]], 3]}";
+	const char *paths[] = { "/meta/host", "/events/*/ts", "/events/2" };
+
+	check(jsmn_matcher_compile(&m, paths, 3) == 0);
+	jsmn_parser_init(&p, t, 32);
+	r = jsmn_parse_projection(&p, &m, js, strlen(js), res, 8);
+	check(r == 4);
+	check(p.factory.toknext == 16);
+	check(tokeq(js, t, 16,
+				JSMN_OBJECT, -1, -1, 2,
+				JSMN_LABEL, "meta", 1,
+				JSMN_OBJECT, -1, -1, 1,
+				JSMN_LABEL, "host", 1,
+				JSMN_STRING, "h", 0,
+				JSMN_LABEL, "events", 1,
+				JSMN_ARRAY, -1, -1, 3,
+				JSMN_OBJECT, -1, -1, 1,
+				JSMN_LABEL, "ts", 1,
+				JSMN_PRIMITIVE, "10",
+				JSMN_ARRAY, -1, -1, 0,
+				JSMN_OBJECT, -1, -1, 1,
+				JSMN_LABEL, "ts", 1,
+				JSMN_OBJECT, -1, -1, 1,
+				JSMN_LABEL, "s", 1,
+				JSMN_PRIMITIVE, "12"));
+	check(t[0].next == 16 && t[6].next == 16 && t[11].next == 16);
+	check(res[0].path == 0 && res[0].token == 4);
+	check(res[1].path == 1 && res[1].token == 9);
+	check(res[2].path == 2 && res[2].token == 11);
+	check(res[3].path == 1 && res[3].token == 13);
+
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse_projection(&p, &m, js, strlen(js), res, 3) ==
+			JSMN_ERROR_NOMEM);
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse_projection(&p, &m, js, strlen(js) - 1, res, 8) ==
+			JSMN_ERROR_PART);
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse_projection(&p, &m, "{\"meta\" 1}", 11, res, 8) ==
+			JSMN_ERROR_INVAL);
+	return 0;
+}
+
+int test_numbers(void) {
+	jsmn_Parser p;
+	jsmn_Token t[32];
+	int64_t i64[8];
+	uint64_t u64[8];
+	double d[8];
+	const char *js = "[0, -0, 42, -9223372036854775808, 9223372036854775807, "
+		"18446744073709551615, 18446744073709551616, 1.5, 1e2, true]";
+	const char *dbl = "[0.1, -2.5e-3, 1E+2, 9007199254740993, 1e23, "
+		"2.2250738585072011e-308, 4.9e-324, 1e-400]";
+
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse(&p, js, strlen(js)) == 11);
+	check(jsmn_get_int64(js, &t[1], &i64[0]) == 0 && i64[0] == 0);
+	check(jsmn_get_int64(js, &t[2], &i64[0]) == 0 && i64[0] == 0);
+	check(jsmn_get_int64(js, &t[3], &i64[0]) == 0 && i64[0] == 42);
+	check(jsmn_get_int64(js, &t[4], &i64[0]) == 0 && i64[0] == INT64_MIN);
+	check(jsmn_get_int64(js, &t[5], &i64[0]) == 0 && i64[0] == INT64_MAX);
+	check(jsmn_get_int64(js, &t[6], &i64[0]) == JSMN_ERROR_RANGE);
+	check(jsmn_get_uint64(js, &t[6], &u64[0]) == 0 && u64[0] == UINT64_MAX);
+	check(jsmn_get_uint64(js, &t[7], &u64[0]) == JSMN_ERROR_RANGE);
+	check(jsmn_get_uint64(js, &t[4], &u64[0]) == JSMN_ERROR_RANGE);
+	check(jsmn_get_uint64(js, &t[2], &u64[0]) == 0 && u64[0] == 0);
+	/* Integers have no fraction or exponent */
+	check(jsmn_get_int64(js, &t[8], &i64[0]) == JSMN_ERROR_INVAL);
+	check(jsmn_get_int64(js, &t[9], &i64[0]) == JSMN_ERROR_INVAL);
+	check(jsmn_get_int64(js, &t[10], &i64[0]) == JSMN_ERROR_INVAL);
+	check(jsmn_get_double(js, &t[10], &d[0]) == JSMN_ERROR_INVAL);
+	check(jsmn_get_double(js, &t[0], &d[0]) == JSMN_ERROR_INVAL);
+	check(jsmn_get_double(js, &t[7], &d[0]) == 0 &&
+			d[0] == 18446744073709551616.0);
+	check(jsmn_get_double(js, &t[8], &d[0]) == 0 && d[0] == 1.5);
+
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse(&p, dbl, strlen(dbl)) == 9);
+	check(jsmn_get_double_array(dbl, t, 0, d, 7) == JSMN_ERROR_NOMEM);
+	check(jsmn_get_double_array(dbl, t, 0, d, 8) == 8);
+	check(d[0] == 0.1 && d[1] == -2.5e-3 && d[2] == 100);
+	check(d[3] == 9007199254740992.0 && d[4] == 1e23);
+	check(d[5] == 2.2250738585072011e-308 && d[6] == 4.9e-324 && d[7] == 0);
+	check(jsmn_get_int64_array(dbl, t, 0, i64, 8) == JSMN_ERROR_INVAL);
+	check(jsmn_get_double_array(dbl, t, 1, d, 8) == JSMN_ERROR_INVAL);
+
+	js = "[1, 2, [3], 4]";
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse(&p, js, strlen(js)) == 6);
+	check(jsmn_get_uint64_array(js, t, 3, u64, 8) == 1 && u64[0] == 3);
+	check(jsmn_get_uint64_array(js, t, 0, u64, 8) == JSMN_ERROR_INVAL);
+	check(jsmn_get_int64_array(js, t, 3, i64, 8) == 1 && i64[0] == 3);
+
+#ifndef JSMN_STRICT
+	/* Leading zeros are invalid */
+	js = "[01]";
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse(&p, js, strlen(js)) == 2);
+	check(jsmn_get_int64(js, &t[1], &i64[0]) == JSMN_ERROR_INVAL);
+	check(jsmn_get_double(js, &t[1], &d[0]) == JSMN_ERROR_INVAL);
+#endif
+
+	js = "[1e309, -1e400]";
+	jsmn_parser_init(&p, t, 32);
+	check(jsmn_parse(&p, js, strlen(js)) == 3);
+	check(jsmn_get_double(js, &t[1], &d[0]) == JSMN_ERROR_RANGE &&
+			d[0] > 1e308);
+	check(jsmn_get_double(js, &t[2], &d[0]) == JSMN_ERROR_RANGE &&
+			d[0] < -1e308);
+	return 0;
+}
+
+int test_unescape(void) {
+	jsmn_Parser p;
+	jsmn_Token t[8];
+	char buf[64];
+	char js[128] = "[\"plain\", \"a\\tb\\\"\\\\\\/\", \"\\u00e9\\u20AC\", "
+		"\"\\ud83d\\ude00!\", \"\\udc00x\\ud800\", \"\\u0000\"]";
+
+	jsmn_parser_init(&p, t, 8);
+	check(jsmn_parse(&p, js, strlen(js)) == 7);
+	/* Strings without escape sequences are used as they are */
+	check(jsmn_string_view(js, &t[1]) == jsmn_token_data(js, &t[1]));
+	check(jsmn_string_view(js, &t[2]) == NULL);
+	check(jsmn_string_view(js, &t[0]) == NULL);
+	check(jsmn_string_length(js, &t[1]) == 5);
+	check(jsmn_string_decode(js, &t[1], buf, 5) == 5);
+	check(memcmp(buf, "plain", 5) == 0);
+	check(jsmn_string_decode(js, &t[1], buf, 4) == JSMN_ERROR_NOMEM);
+
+	check(jsmn_string_length(js, &t[2]) == 6);
+	check(jsmn_string_decode(js, &t[2], buf, 6) == 6);
+	check(memcmp(buf, "a\tb\"\\/", 6) == 0);
+	check(jsmn_string_decode(js, &t[2], buf, 5) == JSMN_ERROR_NOMEM);
+	check(jsmn_string_length(js, &t[3]) == 5);
+	check(jsmn_string_decode(js, &t[3], buf, 64) == 5);
+	check(memcmp(buf, "\xc3\xa9\xe2\x82\xac", 5) == 0);
+	check(jsmn_string_decode(js, &t[4], buf, 64) == 5);
+	check(memcmp(buf, "\xf0\x9f\x98\x80!", 5) == 0);
+	/* Lone surrogates */
+	check(jsmn_string_decode(js, &t[5], buf, 64) == 7);
+	check(memcmp(buf, "\xef\xbf\xbdx\xef\xbf\xbd", 7) == 0);
+	check(jsmn_string_decode(js, &t[6], buf, 64) == 1 && buf[0] == '\0');
+
+	/* In place */
+	check(jsmn_string_decode(js, &t[4], (char *)jsmn_token_data(js, &t[4]),
+				t[4].length) == 5);
+	check(memcmp(jsmn_token_data(js, &t[4]), "\xf0\x9f\x98\x80!", 5) == 0);
+	check(jsmn_string_decode(js, &t[2], (char *)jsmn_token_data(js, &t[2]),
+				t[2].length) == 6);
+	check(memcmp(jsmn_token_data(js, &t[2]), "a\tb\"\\/", 6) == 0);
+	return 0;
+}
+
+int test_utf8(void) {
+	int i;
+	int r;
+	jsmn_Parser p;
+	jsmn_Token t[4];
+	char js[128];
+	const char *valid[] = { "caf\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+		"\xef\xbf\xbf", "\xf4\x8f\xbf\xbf", "\xed\x9f\xbf" };
+	const char *invalid[] = { "\xc3", "\xc3(", "\x80", "\xc0\xaf",
+		"\xe0\x80\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf8\x88\x80\x80",
+		"\xe2\x82", "\xff" };
+
+	/* Place the sequences at every offset of the vector blocks */
+	for (i = 0; i < 40; i++) {
+		for (r = 0; r < sizeof(valid) / sizeof(valid[0]); r++) {
+			sprintf(js, "[\"%*s%s%*s\"]", i, "", valid[r], 40 - i, "");
+			jsmn_parser_init(&p, t, 4);
+			check(jsmn_parse(&p, js, strlen(js)) == 2);
+		}
+		for (r = 0; r < sizeof(invalid) / sizeof(invalid[0]); r++) {
+			sprintf(js, "[\"%*s%s\", \"x\"]", i, "", invalid[r]);
+			jsmn_parser_init(&p, t, 4);
+#ifdef JSMN_STRICT
+			check(jsmn_parse(&p, js, strlen(js)) == JSMN_ERROR_INVAL);
+#else
+			check(jsmn_parse(&p, js, strlen(js)) == 3);
+#endif
+		}
+	}
 	return 0;
 }
 
@@ -391,6 +1806,8 @@ int main(void) {
 	test(test_array, "test for a JSON arrays");
 	test(test_primitive, "test primitive JSON data types");
 	test(test_string, "test string JSON data types");
+	test(test_primitive_kind, "test kind of primitives");
+	test(test_string_flags, "test escape flag of string tokens");
 
 	test(test_partial_string, "test partial JSON string parsing");
 	test(test_partial_array, "test partial array reading");
@@ -402,6 +1819,31 @@ int main(void) {
 	test(test_count, "test tokens count estimation");
 	test(test_nonstrict, "test for non-strict mode");
 	test(test_unmatched_brackets, "test for unmatched brackets");
+	test(test_alloc, "test growing the token array");
+	test(test_stream, "test parsing a stream in a window");
+	test(test_records, "test parsing a batch of records");
+#ifdef JSMN_MMAP
+	test(test_file, "test parsing a mapped file");
+#endif
+#ifdef JSMN_THREADS
+	test(test_parallel, "test parsing records with several threads");
+	test(test_split, "test parsing one document with several threads");
+#endif
+	test(test_depth, "test nesting depth limit");
+	test(test_block_boundaries, "test tokens spanning index blocks");
+	test(test_token_data, "test token data with either token layout");
+	test(test_writer, "test dumping tokens to a buffered writer");
+	test(test_escape, "test escaping plain text when dumping");
+	test(test_serialize, "test serialising tokens without recursion");
+	test(test_append_numbers, "test appending formatted numbers");
+	test(test_arena, "test copying names and values into an arena");
+	test(test_subtree, "test the end of subtrees");
+	test(test_lookup, "test looking up object members");
+	test(test_match, "test matching paths");
+	test(test_projection, "test parsing a projection");
+	test(test_numbers, "test decoding numbers");
+	test(test_unescape, "test decoding strings");
+	test(test_utf8, "test UTF-8 validation of strings");
 	printf("\nPASSED: %d\nFAILED: %d\n", test_passed, test_failed);
 	return (test_failed > 0);
 }
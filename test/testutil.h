@@ -3,7 +3,7 @@
 
 #include "../jsmn.c"
 
-static int vtokeq(const char *s, jsmntok_t *t, int numtok, va_list ap) {
+static int vtokeq(const char *s, jsmn_Token *t, int numtok, va_list ap) {
 	if (numtok > 0) {
 		int i, start, end, size;
 		int type;
@@ -12,8 +12,14 @@ static int vtokeq(const char *s, jsmntok_t *t, int numtok, va_list ap) {
 		size = -1;
 		value = NULL;
 		for (i = 0; i < numtok; i++) {
+#ifdef JSMN_COMPACT_TOKENS
+			int tstart = t[i].start;
+#else
+			int tstart = t[i].data != NULL ? t[i].data - s : -1;
+#endif
+			int tend = tstart + t[i].length;
 			type = va_arg(ap, int);
-			if (type == JSMN_STRING) {
+			if (type == JSMN_STRING || type == JSMN_LABEL) {
 				value = va_arg(ap, char *);
 				size = va_arg(ap, int);
 				start = end = -1;
@@ -31,12 +37,12 @@ static int vtokeq(const char *s, jsmntok_t *t, int numtok, va_list ap) {
 				return 0;
 			}
 			if (start != -1 && end != -1) {
-				if (t[i].start != start) {
-					printf("token %d start is %d, not %d\n", i, t[i].start, start);
+				if (tstart != start) {
+					printf("token %d start is %d, not %d\n", i, tstart, start);
 					return 0;
 				}
-				if (t[i].end != end ) {
-					printf("token %d end is %d, not %d\n", i, t[i].end, end);
+				if (tend != end ) {
+					printf("token %d end is %d, not %d\n", i, tend, end);
 					return 0;
 				}
 			}
@@ -46,11 +52,11 @@ static int vtokeq(const char *s, jsmntok_t *t, int numtok, va_list ap) {
 			}
 
 			if (s != NULL && value != NULL) {
-				const char *p = s + t[i].start;
-				if (strlen(value) != t[i].end - t[i].start ||
-						strncmp(p, value, t[i].end - t[i].start) != 0) {
-					printf("token %d value is %.*s, not %s\n", i, t[i].end-t[i].start,
-							s+t[i].start, value);
+				const char *p = s + tstart;
+				if (strlen(value) != tend - tstart ||
+						strncmp(p, value, tend - tstart) != 0) {
+					printf("token %d value is %.*s, not %s\n", i, tend-tstart,
+							s+tstart, value);
 					return 0;
 				}
 			}
@@ -59,7 +65,7 @@ static int vtokeq(const char *s, jsmntok_t *t, int numtok, va_list ap) {
 	return 1;
 }
 
-static int tokeq(const char *s, jsmntok_t *tokens, int numtok, ...) {
+static int tokeq(const char *s, jsmn_Token *tokens, int numtok, ...) {
 	int ok;
 	va_list args;
 	va_start(args, numtok);
@@ -72,11 +78,11 @@ static int parse(const char *s, int status, int numtok, ...) {
 	int r;
 	int ok = 1;
 	va_list args;
-	jsmn_parser p;
-	jsmntok_t *t = malloc(numtok * sizeof(jsmntok_t));
+	jsmn_Parser p;
+	jsmn_Token *t = malloc(numtok * sizeof(jsmn_Token));
 
-	jsmn_init(&p);
-	r = jsmn_parse(&p, s, strlen(s), t, numtok);
+	jsmn_parser_init(&p, t, numtok);
+	r = jsmn_parse(&p, s, strlen(s));
 	if (r != status) {
 		printf("status is %d, not %d\n", r, status);
 		return 0;